@@ -15,10 +15,13 @@
 #include <atomic>
 
 #include "tchecker/basictypes.hh"
-#include "tchecker/algorithms/covreach/builder.hh"
+#include "tchecker/dbm/dbm.hh"
+#include "tchecker/algorithms/covreach/accepting.hh"
 
+#include "tchecker_ext/algorithms/covreach_ext/builder.hh"
 #include "tchecker_ext/algorithms/covreach_ext/graph.hh"
 #include "tchecker_ext/algorithms/covreach_ext/stats.hh"
+#include "tchecker_ext/utils/safepoint.hh"
 
 #include <tchecker_ext/config.hh>
 
@@ -50,11 +53,22 @@ namespace tchecker_ext {
        */
       template <class NODE_PTR>
       struct working_elements{
+        unsigned int worker=0; // Identifier of the worker, selects its edge arena
         std::vector<NODE_PTR> next_nodes_vec, covered_nodes_vec;
         std::vector<tchecker::graph::cover::node_position_t> associated_container_num;
         std::vector<bool> is_treated;
+        std::vector<std::size_t> locked_stripes;
+        std::vector<tchecker::dbm::db_t> merge_hull, merge_scratch; // Scratch DBMs of zone merging
+        std::vector<tchecker::dbm::db_t const *> union_zones; // Zones of a federation
+        std::vector<tchecker::dbm::db_t> union_pieces, union_next; // Scratch DBMs of covering by federations
       };
       
+      /*!
+       * \brief Number of expanded nodes between two checks of the memory limit and of the compaction
+       * threshold
+       */
+      constexpr unsigned int maintenance_period = 64;
+      
       
       /*!
        * \brief This is the main function executed by each thread to explore the zone graph
@@ -73,16 +87,19 @@ namespace tchecker_ext {
        * @param accepting A callable object or function that takes a node and determines whether it is accepting
        * @param stats Use a vector of stats, one for each threads
        * @param is_reached An atomic flag to signal termination among threads
+       * @param safepoint Stop-the-world phases (compaction of the graph), polled whenever the worker holds
+       * no lock and no node
        * \note thread-safe here means is more "strict" then traditional thread-safe, as the reference counter of each
        *       object is not thread-safe. Therefore the reference counter may only change when the corresponding object
-       *       is locked
+       *       is locked, unless the reference counters are atomic (see tchecker_ext::covreach_ext::graph_t::release_node())
        */
       template <class GRAPH, class BUILDER, class WAITING, class ACCEPTING, class STATS>
       void worker_fun(const int worker_num, GRAPH & graph, BUILDER & builder, WAITING & waiting, ACCEPTING & accepting,
-          STATS & stats, std::atomic_bool & is_reached) {
+          STATS & stats, std::atomic_bool & is_reached, tchecker_ext::safepoint_t & safepoint) {
         using node_ptr_t = typename GRAPH::node_ptr_t;
         
         working_elements<node_ptr_t> this_work_elems;
+        this_work_elems.worker = worker_num;
         node_ptr_t current_node{nullptr};
         std::vector<node_ptr_t> &next_nodes_vec = this_work_elems.next_nodes_vec;
         
@@ -96,13 +113,19 @@ namespace tchecker_ext {
                     builder, graph, next_nodes_vec, stats);
         };
         
+        unsigned int n_expanded = 0;
+        
         // Stop if some other thread reached the label
         next_nodes_vec.clear();
-        while (!is_reached && waiting.pop_and_increment(current_node)) {
+        // Workers waiting for other workers to insert nodes hold no node either
+        auto idle = [&] () { safepoint.poll(); };
+        while (!is_reached && waiting.pop_and_increment(current_node, idle)) {
 
           // Check if done
           if (accepting(current_node)) {
             stats.increment_visited_nodes();
+            // The reference counter of a node only changes under the lock of its stripe (unless it is atomic)
+            graph.release_node(current_node);
             // No successors of final state
             assert(next_nodes_vec.empty());
             waiting.insert_and_decrement(next_nodes_vec);
@@ -110,6 +133,7 @@ namespace tchecker_ext {
             is_reached = true;
             // all work is done
             std::cout << "worker " << worker_num << " reached final state" << std::endl;
+            safepoint.leave();
             return;
           }
           
@@ -126,7 +150,16 @@ namespace tchecker_ext {
           waiting.insert_and_decrement(next_nodes_vec, true);
           // Done
           assert(next_nodes_vec.empty());
+          
+          if (++n_expanded % maintenance_period == 0) {
+            graph.relieve_memory_pressure();
+            if (graph.compaction_due()) {
+              safepoint.request();
+            }
+            safepoint.poll();
+          }
         }
+        safepoint.leave();
         if(is_reached){
           std::cout << "worker " << worker_num << " terminates because another thread reached the goal" << std::endl;
         }else{
@@ -140,7 +173,7 @@ namespace tchecker_ext {
        * \brief Computes the successors of a given node; In order to be thread safe, the graph is not allowed
        * to be modified (only used to compare the nodes),
        * The reference counter of the parent node is not allowed to change
-       * @tparam BUILDER builder with threaded allocation for the transitions (singleton_pool_allocator ...)
+       * @tparam BUILDER builder computing the successors in a scratch node, tchecker_ext::threaded_ts::scratch_builder_t
        * @tparam GRAPH
        * @tparam STATS
        * @param worker_num
@@ -149,47 +182,25 @@ namespace tchecker_ext {
        * @param graph
        * @param nodes vector of nodes to store the successors; Has to be empty on call
        * @param stats
+       * \note Successors that are not OK or that are covered by some other successor ("direct covering")
+       * are dropped in the scratch node of builder, only the others are allocated. A successor covered by a
+       * later one is made inactive
        */
       template <class BUILDER, class GRAPH, class STATS>
       void expand_node(const int worker_num, const typename GRAPH::node_ptr_t & node,
            BUILDER & builder, const GRAPH & graph, std::vector<typename GRAPH::node_ptr_t> & nodes,
            STATS & stats) {
         using node_ptr_t = typename GRAPH::node_ptr_t;
-        using transition_ptr_t = typename GRAPH::ts_allocator_t::transition_ptr_t;
         
         assert(nodes.empty());
         
-        node_ptr_t next_node{nullptr};
-        transition_ptr_t transition{nullptr};
-        
-        auto outgoing_range = builder.outgoing(node);
-  
-        // todo Do something to determine the size of a range
-        // this way copying the vector when expanding it could be avoided
-        // New elements are constructed with constructed with null_ptr
-        for (auto it = outgoing_range.begin(); !it.at_end(); ++it) {
-          std::tie(next_node, transition) = *it;
-          assert(next_node.ptr() != nullptr);
-          // Swaps a null_reference with the next_node
-          nodes.emplace_back(nullptr);
-          next_node.swap(nodes.back());
+        std::size_t const directly_covered =
+            builder.outgoing(node, nodes, [&graph] (node_ptr_t const & n1, node_ptr_t const & n2) {
+              return graph.is_le(n1, n2);
+            });
+        for (std::size_t i = 0; i < directly_covered; ++i) {
+          stats.increment_directly_covered_leaf_nodes();
         }
-        // Check for each node if covered by some other node
-        // in nodes, called "direct_covering"
-        for (auto &node_a : nodes) {
-          for (const auto &node_b : nodes) {
-            if (node_a == node_b) {
-              // Do not compare to self
-              continue;
-            }
-            if ( node_b->is_active() && (graph.is_le(node_a, node_b))) {
-              node_a->make_inactive();
-              // Once it is inactive -> continue
-              stats.increment_directly_covered_leaf_nodes();
-              break;
-            } // if
-          } // for node_b
-        } // for node_a
       } //expand_node
       
     } // threaded_working
@@ -199,19 +210,19 @@ namespace tchecker_ext {
      \brief Reachability algorithm with node covering and possible multi-threading
      \tparam TS : type of transition system, should derive from tchecker::ts::ts_t
      \tparam GRAPH : type of graph, should derive from tchecker_ext::covreach_ext::graph_t
-     \tparam WAITING : type of waiting container, should derive from tchecker_ext::covreach_ext::threaded_waiting_t
+     \tparam WAITING : type of waiting container, should derive from tchecker_ext::covreach_ext::threaded_waiting_t.
+     It is instantiated with the lock type of GRAPH
      */
-    template <class TS, class BUILD_ALLOC, class GRAPH, template <class NPTR> class WAITING>
+    template <class TS, class BUILD_ALLOC, class GRAPH, template <class NPTR, class LOCK> class WAITING>
     class algorithm_t {
       using ts_t = TS;
       using builder_alloc_t = BUILD_ALLOC;
-      using transition_t = typename GRAPH::ts_allocator_t::transition_t;
-      using transition_ptr_t = typename GRAPH::ts_allocator_t::transition_ptr_t;
       using graph_t = GRAPH;
       using ts_allocator_t = typename GRAPH::ts_allocator_t;
       using node_ptr_t = typename GRAPH::node_ptr_t;
       using edge_ptr_t = typename GRAPH::edge_ptr_t;
-      using builder_t = typename tchecker::covreach::builder_t<ts_t, builder_alloc_t>;
+      using builder_t = typename tchecker_ext::threaded_ts::scratch_builder_t<ts_t, builder_alloc_t>;
+      using waiting_t = WAITING<node_ptr_t, typename GRAPH::lock_t>;
     public:
       /*!
        \brief Multithreaded reachability algorithm with node covering
@@ -237,18 +248,23 @@ namespace tchecker_ext {
       {
         using accepting_t = tchecker::covreach::accepting_labels_t<node_ptr_t>;
         
+        // Graph and waiting are not synchronized with a non-concurrent lock
+        assert(GRAPH::lock_t::concurrent || (num_threads == 1));
+        
         std::deque<builder_t> builder_vec;
         // Todo change this such that all threads can share one accepting object
         // this facilitates the implementation of fastest trace etc
         std::deque<tchecker::covreach::accepting_labels_t<node_ptr_t>> accepting_vec; //Avoids conversion to std::function
         
-        WAITING<node_ptr_t> waiting;
+        waiting_t waiting;
         std::vector<node_ptr_t> nodes;
         std::deque<tchecker_ext::covreach_ext::stats_t> stats_vec; // One stat per thread
         std::deque<std::thread> thread_vec;
 
         // "Flag" to signal whether some thread found an accepting node
         std::atomic_bool is_reached=false;
+        // Compactions run while all workers are parked
+        tchecker_ext::safepoint_t safepoint(num_threads, [&graph] () { graph.compact(); });
         
         tchecker::spinlock_t initial_lock;
         // Release before threads are launched
@@ -283,16 +299,17 @@ namespace tchecker_ext {
         for (unsigned int i=0; i<num_threads-1; ++i){
           std::cout << "Thread " << i << " uses ts " << &ts_vec[i] << " and builder " << &builder_vec[i] << std::endl;
           thread_vec.emplace_back( tchecker_ext::covreach_ext::threaded_working::worker_fun<graph_t,
-                                     builder_t, WAITING<node_ptr_t>, accepting_t, tchecker_ext::covreach_ext::stats_t>,
+                                     builder_t, waiting_t, accepting_t, tchecker_ext::covreach_ext::stats_t>,
                                      i, std::ref(graph), std::ref(builder_vec[i]), std::ref(waiting), std::ref(accepting_vec[i]),
-                                     std::ref(stats_vec[i]), std::ref(is_reached) );
+                                     std::ref(stats_vec[i]), std::ref(is_reached),
+                                     std::ref(safepoint) );
         }
         
         // The last "thread" runs in the main thread
         // As this is blocking, we know when we are done
         std::cout << "Thread base uses ts " << &ts_vec.back() << " and builder " << &builder_vec.back() << std::endl;
-        tchecker_ext::covreach_ext::threaded_working::worker_fun<graph_t, builder_t, WAITING<node_ptr_t>,
-            accepting_t, tchecker_ext::covreach_ext::stats_t>(num_threads-1, graph, builder_vec.back(), waiting, accepting_vec.back(), stats_vec.back(), is_reached);
+        tchecker_ext::covreach_ext::threaded_working::worker_fun<graph_t, builder_t, waiting_t,
+            accepting_t, tchecker_ext::covreach_ext::stats_t>(num_threads-1, graph, builder_vec.back(), waiting, accepting_vec.back(), stats_vec.back(), is_reached, safepoint);
         
         // Wait till all are joined
         for (auto & it : thread_vec){
@@ -311,21 +328,14 @@ namespace tchecker_ext {
        \param nodes : a vector of nodes
        \post the initial nodes provided by builder have been added to graph and to nodes
        */
-      void expand_initial_nodes(tchecker::covreach::builder_t<TS, builder_alloc_t > & builder, GRAPH & graph,
-                                std::vector<node_ptr_t> & nodes)
+      void expand_initial_nodes(builder_t & builder, GRAPH & graph, std::vector<node_ptr_t> & nodes)
       {
-        node_ptr_t node{nullptr};
-        transition_ptr_t transition{nullptr};
-        
-        auto initial_range = builder.initial();
-        for (auto it = initial_range.begin(); ! it.at_end(); ++it) {
-          std::tie(node, transition) = *it;
+        builder.initial(nodes);
+        for (node_ptr_t const & node : nodes) {
           assert(node != node_ptr_t{nullptr});
           
           assert(node->is_active());//todo
           graph.add_node(node, GRAPH::ROOT_NODE);
-          
-          nodes.push_back(node);
         }
       }
     };
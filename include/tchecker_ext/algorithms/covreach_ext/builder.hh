@@ -6,6 +6,13 @@
 #ifndef TCHECKER_EXT_ALLOCATOR_HH
 #define TCHECKER_EXT_ALLOCATOR_HH
 
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "tchecker/basictypes.hh"
 #include "tchecker/ts/allocators.hh"
 
 namespace tchecker_ext{
@@ -85,9 +92,13 @@ namespace tchecker_ext{
     /*!
      \class threaded_builder_allocator_t
      \brief Auxilliary class to allow for multithreaded exploration
-     \note This is basically a work-around to the problem of the singleton allocated transition
-           threaded_builder_allocators share a common allocator for the states, but each holds its own
-           singleton_pool for the transition
+     \note threaded_builder_allocators share a common allocator for the states. They allocate no
+           transition: successors are computed with a transition owned by the builder (see
+           scratch_builder_t), so there is no per-thread transition allocator
+     \note If built with state allocator arguments, a threaded_builder_allocator_t owns a state allocator
+           as well (per-thread arena): the states built by its thread never contend with other threads.
+           States are never freed by the thread dropping the last reference: the garbage collector
+           collects each arena in batches
      \tparam STATE_ALLOCATOR : type of state allocator
      \tparam TRANSITION_ALLOCATOR : type of transition allocator
      */
@@ -122,18 +133,27 @@ namespace tchecker_ext{
   
       /*!
        \brief Constructor
+       \param ts_allocator : allocator of the graph
+       \post all states are allocated from the state allocator of ts_allocator
+       */
+      explicit threaded_builder_allocator_t(TS_ALLOCATOR &ts_allocator)
+          : _ts_allocator(ts_allocator)
+      {}
+  
+      /*!
+       \brief Constructor with a private state allocator
        \param gc : garbage collector
-       \param sa_args : parameters to a constructor of STATE_ALLOCATOR
-       \param ta_args : parameters to a constructor of TRANSITION_ALLOCATOR
-       \post this owns a state allocator built from sa_args, and a transition allocator built from ta_args.
-       Both allocators have been enrolled to gc
+       \param ts_allocator : allocator of the graph
+       \param sa_args : parameters to a constructor of the state allocator
+       \post this owns a state allocator built from sa_args, enrolled to gc. All states are allocated from
+       the owned state allocator
        */
-      template <class ... TA_ARGS>
-      threaded_builder_allocator_t(tchecker::gc_t & gc, TS_ALLOCATOR &ts_allocator, std::tuple<TA_ARGS...> && ta_args)
+      template <class ... SA_ARGS>
+      threaded_builder_allocator_t(tchecker::gc_t & gc, TS_ALLOCATOR &ts_allocator, std::tuple<SA_ARGS...> && sa_args)
           : _ts_allocator(ts_allocator),
-            _transition_allocator(std::make_from_tuple<transition_allocator_t >(ta_args))
+            _state_allocator(std::apply([] (auto && ... a) { return new state_allocator_t(a...); }, sa_args))
       {
-        _transition_allocator.enroll(gc);
+        _state_allocator->enroll(gc);
       }
   
       /*!
@@ -165,27 +185,29 @@ namespace tchecker_ext{
       operator= (tchecker_ext::threaded_ts::threaded_builder_allocator_t<TS_ALLOCATOR> &&) = delete;
   
       /*!
-       \brief transitions destruction
-       \post all allocated transitions have been deleted. All pointers
-       returned by method allocate_transition() have been invalidated
+       \brief States destruction
+       \post all states allocated by the owned state allocator (if any) have been deleted
        */
       void destruct_all()
       {
-        _transition_allocator.destruct_all();
+        if (_state_allocator)
+          _state_allocator->destruct_all();
       }
   
       /*!
        \brief Fast memory deallocation
-       \post all allocated transitions have been freed. No destructor
-       has been called. All pointers returned by methods allocate_state(),
-       allocate_from_state() and allocate_transition() have been invalidated
+       \post all states allocated by the owned state allocator (if any) have been freed.
+       No destructor has been called. All pointers returned by methods construct_state() and
+       construct_from_state() from the owned state allocator have been invalidated
+       \note states owned by this must not be referenced anymore (graph cleared)
        */
       void free_all()
       {
-        _transition_allocator.free_all();
+        if (_state_allocator)
+          _state_allocator->free_all();
       }
       
-      //Everything concerning the states is "forward" to the ts_allocator
+      //Everything concerning the states is "forward" to the owned state allocator if any, to the ts_allocator otherwise
       /*!
        \brief State construction
        \param args : parameters to a constructor of state_t
@@ -194,6 +216,8 @@ namespace tchecker_ext{
       template <class ... ARGS>
       inline state_ptr_t construct_state(ARGS && ... args)
       {
+        if (_state_allocator)
+          return _state_allocator->construct(std::forward<ARGS>(args)...);
         return _ts_allocator.template construct_state(std::forward<ARGS>(args)...);
       }
   
@@ -205,6 +229,9 @@ namespace tchecker_ext{
       template <class ... ARGS>
       inline state_ptr_t construct_state(std::tuple<ARGS...> && args)
       {
+        if (_state_allocator)
+          return std::apply([this] (auto && ... a) { return _state_allocator->construct(std::forward<decltype(a)>(a)...); },
+                            std::forward<std::tuple<ARGS...>>(args));
         return _ts_allocator.template construct_state(std::forward<std::tuple<ARGS...>>(args));
       }
   
@@ -217,6 +244,8 @@ namespace tchecker_ext{
       template <class ... ARGS>
       inline state_ptr_t construct_from_state(state_ptr_t const & state, ARGS && ... args)
       {
+        if (_state_allocator)
+          return _state_allocator->construct_from_state(state, std::forward<ARGS>(args)...);
         return _ts_allocator.template construct_from_state(state, std::forward<ARGS>(args)...);
       }
   
@@ -229,6 +258,10 @@ namespace tchecker_ext{
       template <class ... ARGS>
       inline state_ptr_t construct_from_state(state_ptr_t const & state, std::tuple<ARGS...> && args)
       {
+        if (_state_allocator)
+          return std::apply([this, &state] (auto && ... a) {
+            return _state_allocator->construct_from_state(state, std::forward<decltype(a)>(a)...);
+          }, std::forward<std::tuple<ARGS...>>(args));
         return _ts_allocator.template construct_from_state(state, std::forward<std::tuple<ARGS...>>(args));
       }
   
@@ -242,64 +275,155 @@ namespace tchecker_ext{
        */
       bool destruct_state(state_ptr_t & p)
       {
+        if (_state_allocator)
+          return _state_allocator->destruct(p);
         return _ts_allocator.destruct_state(p);
       }
       
+    protected:
+      TS_ALLOCATOR &_ts_allocator; /*!reference to "original" allocator*/
+      std::unique_ptr<state_allocator_t> _state_allocator; /*! Per-thread state arena, nullptr if states come from _ts_allocator */
+  
+    };
+  
+  
+    /*!
+     \class scratch_builder_t
+     \brief Builder that computes successors in a scratch node and only allocates the ones that survive
+     \tparam TS : type of transition system, should derive from tchecker::ts::ts_t
+     \tparam ALLOCATOR : type of allocator, should be tchecker_ext::threaded_ts::threaded_builder_allocator_t
+     \note tchecker::covreach::builder_t::outgoing() allocates a node and a transition for every outgoing
+     edge before the successor is computed. Here, each successor is computed into a scratch node owned by
+     the builder (a copy of the parent, reset for every edge). Successors that are not OK (e.g. empty zone)
+     or that are directly covered by a previous successor are dropped from the scratch node: only the other
+     ones are copied into a node from the allocator
+     \note no transition object is ever allocated: the transition system fills a single transition owned by
+     the builder, which is overwritten by every successor. Hence this builder cannot be used when
+     transitions are output (traces, labeled edges)
+     \note a builder is used by a single thread. Its scratch node is private to the builder and is never
+     stored in the graph
+     */
+    template <class TS, class ALLOCATOR>
+    class scratch_builder_t {
+    public:
       /*!
-       \brief Transition construction
-       \param args : tuple of parameters to a constructor of transition_t
-       \return pointer to a newly allocated transition constructed from args
+       \brief Type of pointers to node
        */
-      template <class ... ARGS>
-      inline transition_ptr_t construct_transition(std::tuple<ARGS...> && args)
-      {
-        return
-            std::apply(&tchecker_ext::threaded_ts::threaded_builder_allocator_t<TS_ALLOCATOR>::_construct_transition<ARGS...>,
-                       std::tuple_cat(std::make_tuple(this), args));
-      }
-  
+      using node_ptr_t = typename ALLOCATOR::state_ptr_t;
+      
       /*!
-       \brief Destruct transition
-       \param p : pointer to transition
-       \pre p has been allocated by this allocator
-       p is not nullptr
-       \post the transition pointed by p has been destructed and set to nullptr if its reference
-       counter is 1 (i.e. p is the only pointer to this transition)
+       \brief Type of transitions
+       */
+      using transition_t = typename ALLOCATOR::transition_t;
+      
+      /*!
+       \brief Constructor
+       \param ts : a transition system
+       \param allocator : an allocator
+       \note this keeps references on ts and allocator
+       */
+      scratch_builder_t(TS & ts, ALLOCATOR & allocator)
+      : _ts(ts),
+        _allocator(allocator),
+        _scratch{nullptr}
+      {}
+      
+      scratch_builder_t(tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> const &) = delete;
+      scratch_builder_t(tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> &&) = default;
+      ~scratch_builder_t() = default;
+      tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> &
+      operator= (tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> const &) = delete;
+      tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> &
+      operator= (tchecker_ext::threaded_ts::scratch_builder_t<TS, ALLOCATOR> &&) = delete;
+      
+      /*!
+       \brief Initial nodes
+       \param nodes : vector of nodes
+       \post the OK initial nodes of the transition system, newly allocated with reference counter 1, have
+       been appended to nodes
        */
-      bool destruct_transition(transition_ptr_t & p)
+      void initial(std::vector<node_ptr_t> & nodes)
       {
-        return _transition_allocator.destruct(p);
+        auto edges = _ts.initial();
+        for (auto it = edges.begin(); !it.at_end(); ++it){
+          node_ptr_t node = _allocator.construct_state(std::make_tuple());
+          if (_ts.initialize(*node, _transition, *it) != tchecker::STATE_OK){
+            continue;
+          }
+          nodes.emplace_back(nullptr);
+          node.swap(nodes.back());
+        }
       }
-  
+      
       /*!
-       \brief Enroll on garbage collector
-       \param gc : garbage collector
-       \pre this is not enrolled to a garbage collector yet
-       \post this is enrolled to gc
+       \brief Surviving successors
+       \param node : a node
+       \param nodes : vector of nodes, empty on call
+       \param le_node : covering predicate over nodes
+       \pre node is not modified by other threads
+       \post nodes contains the OK successors of node that are not covered by a previous successor, newly
+       allocated with reference counter 1. Those covered by a later successor have been made inactive
+       \return number of successors that are directly covered by another successor
        */
-      void enroll(tchecker::gc_t & gc)
+      template <class LE_NODE>
+      std::size_t outgoing(node_ptr_t const & node, std::vector<node_ptr_t> & nodes, LE_NODE && le_node)
       {
-        _transition_allocator.enroll(gc);
+        assert(nodes.empty());
+        if (_scratch.ptr() == nullptr){
+          _scratch = _allocator.construct_from_state(node);
+        }
+        
+        std::size_t directly_covered = 0;
+        auto edges = _ts.outgoing_edges(*node);
+        for (auto it = edges.begin(); !it.at_end(); ++it){
+          reset(node);
+          if (_ts.next(*_scratch, _transition, *it) != tchecker::STATE_OK){
+            continue;
+          }
+          bool covered = false;
+          for (node_ptr_t const & n : nodes){
+            if (n->is_active() && le_node(_scratch, n)){
+              covered = true;
+              break;
+            }
+          }
+          if (covered){
+            ++directly_covered;
+            continue;
+          }
+          node_ptr_t next_node = _allocator.construct_from_state(_scratch);
+          for (node_ptr_t const & n : nodes){
+            if (n->is_active() && le_node(n, next_node)){
+              n->make_inactive();
+              ++directly_covered;
+            }
+          }
+          // Swaps a null_reference with the next_node
+          nodes.emplace_back(nullptr);
+          next_node.swap(nodes.back());
+        }
+        return directly_covered;
       }
-
-
-
+      
     protected:
-  
       /*!
-       \brief Transition construction
-       \param args : parameters to a constructor of transition_t
-       \return pointer to a newly allocated transiton constructed from args
+       \brief Reset the scratch node
+       \param node : a node
+       \pre the scratch node has been allocated from a node of the same model
+       \post the tuple of locations, the integer valuation and the zone of the scratch node are equal to the ones
+       of node. Nothing is allocated
        */
-      template <class ... ARGS>
-      inline transition_ptr_t _construct_transition(ARGS && ... args)
+      void reset(node_ptr_t const & node)
       {
-        return _transition_allocator.construct(args...);
+        *_scratch->vloc_ptr() = node->vloc();
+        *_scratch->intvars_valuation_ptr() = node->intvars_valuation();
+        *_scratch->zone_ptr() = node->zone();
       }
       
-      TS_ALLOCATOR &_ts_allocator; /*!reference to "original" allocator*/
-      transition_allocator_t  _transition_allocator; /*! Holds it own transition allocator for threaded building*/
-  
+      TS & _ts; /*!< Transition system */
+      ALLOCATOR & _allocator; /*!< Allocator of the surviving successors */
+      node_ptr_t _scratch; /*!< Scratch node, successors are computed in it */
+      transition_t _transition; /*!< Scratch transition, never allocated */
     };
     
   }
@@ -0,0 +1,289 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_COMPRESSED_ZONES_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_COMPRESSED_ZONES_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/compressed_dbm.hh"
+#include "tchecker_ext/dbm/simd.hh"
+#include "tchecker_ext/utils/lock_stripes.hh"
+#include "tchecker_ext/utils/memory.hh"
+#include "tchecker_ext/utils/spinlock.hh"
+
+/*!
+ \file compressed_zones.hh
+ \brief Zones of passed nodes stored as minimal sets of constraints
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class compressed_zone_store_t
+     \brief Minimal constraints of the zones of passed nodes, in block arenas
+     \tparam NODE_PTR : type of pointer to node, see tchecker_ext::covreach_ext::node_t
+     \note Once a node has been expanded, its zone is only used to decide covering. Its dense DBM can
+     then be replaced by its minimal set of constraints: the constraints are stored as a record (see
+     tchecker_ext::dbm_ext::compressed_dbm_t) in an arena, the node keeps a handle to the record and
+     releases its zone. A node is compressed, and its constraints are accessed, only under the lock of
+     its stripe
+     \note Arenas are shared by groups of stripes (at most max_arenas arenas), each arena has its own lock
+     that is only held to allocate a record. Records are not freed one by one: the record of an erased
+     node is dead space until clear()
+     */
+    template <class NODE_PTR>
+    class compressed_zone_store_t {
+    public:
+      /*!
+       \brief Maximal number of arenas
+       */
+      static constexpr std::size_t max_arenas = 64;
+
+      /*!
+       \brief Constructor
+       \param huge_pages : whether the blocks of the arenas are advised for transparent huge pages
+       \post this has no arena, see init()
+       */
+      explicit compressed_zone_store_t(bool huge_pages=false)
+      : _huge_pages(huge_pages)
+      {}
+
+      compressed_zone_store_t(tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> const &) = delete;
+      compressed_zone_store_t(tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> &&) = delete;
+      ~compressed_zone_store_t() = default;
+      tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> const &) = delete;
+      tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR> &&) = delete;
+
+      /*!
+       \brief Initialization
+       \param n_stripes : number of stripes of the nodes table
+       \post this has min(n_stripes, max_arenas) empty arenas
+       \note called by the graph that stores the nodes
+       */
+      void init(std::size_t n_stripes)
+      {
+        assert(n_stripes > 0);
+        _n_arenas = std::min(n_stripes, max_arenas);
+        _locks.reset(new tchecker_ext::lock_stripes_t<tchecker_ext::spinlock_t>(_n_arenas));
+        _arenas.reset(new tchecker_ext::cache_aligned_t<arena_t>[_n_arenas]);
+        for (std::size_t a = 0; a < _n_arenas; ++a)
+          _arenas[a].value.blocks.reset(new tchecker_ext::memory::block_allocator_t(_huge_pages));
+      }
+
+      /*!
+       \brief Compression
+       \param stripe : stripe of node
+       \param node : a node
+       \pre stripe is locked by the caller, node has been expanded and is stored in stripe, its zone is tight
+       and not empty
+       \post the minimal constraints of the zone of node are stored in this, node has a handle to them.
+       node still holds its zone
+       \note the caller then releases the zone of node (the zone may be shared, see zone_intern_table_t)
+       */
+      void compress(std::size_t stripe, NODE_PTR const & node)
+      {
+        assert(!is_compressed(node));
+        std::size_t const a = stripe % _n_arenas;
+        arena_t & arena = _arenas[a].value;
+        tchecker::clock_id_t const dim = node->zone().dim();
+        // The record is allocated under the lock of the arena
+        node->compressed_zone() =
+            tchecker_ext::dbm_ext::compressed_dbm_t::make(node->zone().dbm(), dim,
+                                                          [&] (std::size_t bytes, std::size_t align) {
+              (*_locks)[a].lock();
+              void * p = arena.blocks->allocate(bytes, align);
+              (*_locks)[a].unlock();
+              _arena_bytes.fetch_add(bytes, std::memory_order_relaxed);
+              return p;
+            });
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _live_dbm_bytes.fetch_add(dim * dim * sizeof(tchecker::dbm::db_t), std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \param node : a node
+       \return true if the zone of node is stored in this, false otherwise
+       */
+      inline static bool is_compressed(NODE_PTR const & node)
+      {
+        return (node->compressed_zone() != nullptr);
+      }
+
+      /*!
+       \brief Erase
+       \param stripe : stripe of node
+       \param node : a node
+       \pre stripe is locked by the caller
+       \post node has no handle to constraints in this. Its record (if any) is dead space
+       */
+      void erase(std::size_t stripe, NODE_PTR const & node)
+      {
+        if (!is_compressed(node))
+          return;
+        tchecker::clock_id_t const dim = node->compressed_zone()->dim();
+        node->compressed_zone() = nullptr;
+        _count.fetch_sub(1, std::memory_order_relaxed);
+        _live_dbm_bytes.fetch_sub(dim * dim * sizeof(tchecker::dbm::db_t), std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Zone inclusion
+       \param n1 : node
+       \param n2 : node
+       \pre n1 or n2 is compressed. The stripe of n1 and n2 is locked by the caller
+       \return true if the zone of n1 is included in the zone of n2, false otherwise
+       \note if only n2 is compressed, inclusion is decided on the record of n2. If only n1 is compressed and
+       its record is dense, inclusion is decided on it. Otherwise the zone of n1 is expanded in a per-thread
+       scratch DBM, after a fast rejection test on its constraints
+       */
+      bool is_le(NODE_PTR const & n1, NODE_PTR const & n2) const
+      {
+        static thread_local std::vector<tchecker::dbm::db_t> scratch;
+
+        if (!is_compressed(n1))
+          return n2->compressed_zone()->is_ge(n1->zone().dbm());
+
+        tchecker_ext::dbm_ext::compressed_dbm_t const & c1 = *n1->compressed_zone();
+        if (!is_compressed(n2)) {
+          if (!c1.may_be_le(n2->zone().dbm()))
+            return false;
+          if (c1.is_dense())
+            return true;
+        }
+        std::size_t const size = static_cast<std::size_t>(c1.dim()) * c1.dim();
+        if (scratch.size() < size)
+          scratch.resize(size);
+        c1.expand(scratch.data());
+        if (is_compressed(n2))
+          return n2->compressed_zone()->is_ge(scratch.data());
+        return tchecker_ext::dbm_ext::is_le(scratch.data(), n2->zone().dbm(), c1.dim());
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this, the nodes with a handle to constraints in this are not accessed
+       anymore (the graph is being cleared)
+       \post all arenas are empty, their blocks have been given back to the system
+       */
+      void clear()
+      {
+        for (std::size_t a = 0; a < _n_arenas; ++a)
+          _arenas[a].value.blocks->release_all();
+        _count.store(0, std::memory_order_relaxed);
+        _live_dbm_bytes.store(0, std::memory_order_relaxed);
+        _arena_bytes.store(0, std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return number of compressed zones
+       \note thread safe
+       */
+      inline std::size_t count() const
+      {
+        return _count.load(std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return number of bytes allocated from the arenas (records of erased nodes included)
+       \note thread safe
+       */
+      inline std::size_t arena_bytes() const
+      {
+        return _arena_bytes.load(std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return number of bytes mapped by the blocks of the arenas
+       \note not thread safe: the arenas grow under their locks
+       */
+      std::size_t reserved_bytes() const
+      {
+        std::size_t bytes = 0;
+        for (std::size_t a = 0; a < _n_arenas; ++a)
+          bytes += _arenas[a].value.blocks->reserved();
+        return bytes;
+      }
+
+      /*!
+       \brief Accessor
+       \return fraction of the bytes mapped by the arenas that has been allocated (records of erased nodes
+       and alignment padding included), 0 if no block is mapped
+       \note not thread safe, see reserved_bytes()
+       */
+      double occupancy() const
+      {
+        std::size_t used = 0;
+        for (std::size_t a = 0; a < _n_arenas; ++a)
+          used += _arenas[a].value.blocks->used();
+        std::size_t const reserved = reserved_bytes();
+        return (reserved == 0 ? 0.0 : static_cast<double>(used) / static_cast<double>(reserved));
+      }
+
+      /*!
+       \brief Accessor
+       \return size of the dense DBMs of the compressed zones (bytes)
+       \note thread safe
+       */
+      inline std::size_t dbm_bytes() const
+      {
+        return _live_dbm_bytes.load(std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return net number of bytes saved by compression: size of the dense DBMs of the compressed zones,
+       minus the bytes allocated from the arenas, minus the handles of the compressed nodes (negative if
+       compression costs memory)
+       \note every node carries a handle, compressed or not. Only the handles of compressed nodes are
+       counted here
+       \note thread safe
+       */
+      long long saved_bytes() const
+      {
+        return static_cast<long long>(dbm_bytes()) - static_cast<long long>(arena_bytes())
+        - static_cast<long long>(count() * sizeof(tchecker_ext::dbm_ext::compressed_dbm_t const *));
+      }
+
+    private:
+      /*!
+       \class arena_t
+       \brief Records of the compressed zones of a group of stripes
+       */
+      struct arena_t {
+        std::unique_ptr<tchecker_ext::memory::block_allocator_t> blocks; /*!< Blocks of records */
+      };
+
+      bool _huge_pages; /*!< Whether the blocks are advised for transparent huge pages */
+      std::size_t _n_arenas = 0; /*!< Number of arenas */
+      std::unique_ptr<tchecker_ext::lock_stripes_t<tchecker_ext::spinlock_t>> _locks; /*!< One lock per arena */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<arena_t>[]> _arenas; /*!< Arenas */
+      std::atomic<std::size_t> _count{0}; /*!< Number of compressed zones */
+      std::atomic<std::size_t> _live_dbm_bytes{0}; /*!< Size of the dense DBMs of the compressed zones */
+      std::atomic<std::size_t> _arena_bytes{0}; /*!< Bytes allocated from the arenas */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_COMPRESSED_ZONES_HH
@@ -0,0 +1,492 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_CSR_GRAPH_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_CSR_GRAPH_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "tchecker/algorithms/covreach/graph.hh"
+
+#include <tchecker_ext/config.hh>
+
+/*!
+ \file csr_graph.hh
+ \brief Compact (compressed sparse row) post-run snapshot of a covering graph
+ */
+
+namespace tchecker_ext{
+  namespace covreach_ext{
+
+    /*!
+     \class csr_graph_t
+     \brief Read-only snapshot of a covering graph in compressed sparse row format
+     \tparam NODE_PTR : type of pointers to node
+     \note Nodes are identified by dense ids 0..nodes_count()-1. The outgoing (resp. incoming) edges of
+     node i are stored contiguously in [out_begin(i), out_end(i)) (resp. [in_begin(i), in_end(i))).
+     An edge is stored as the id of the other node shifted by one bit, the lowest bit holds the edge type
+     (1 for an actual edge, 0 for an abstract edge)
+     \note Node ids and edges are 32 bits wide, which halves the size of the adjacency arrays compared to
+     pointers. Hence a snapshot holds less than 2^31 nodes. Only the snapshot uses 32 bits ids: while the
+     algorithm runs, the nodes table, the edges and the waiting containers refer to nodes by pointers
+     \note The snapshot holds one reference to each node. It has to be cleared before the allocator
+     of the nodes is freed
+     \note The snapshot is built once exploration is over (see graph_t::freeze()). It keeps the nodes
+     alive, so the intrusive edges and buckets of the graph can be released before the graph is output.
+     It has the read-only interface of a graph that the outputters of tchecker walk (nodes(),
+     outgoing_edges(), incoming_edges(), edge_src(), edge_tgt() and edge_type() on edges), hence
+     tchecker::covreach::dot_outputter_t outputs it as it outputs the graph
+     */
+    template <class NODE_PTR>
+    class csr_graph_t {
+    public:
+      using node_ptr_t = NODE_PTR;
+      using node_id_t = std::uint32_t;
+      using packed_edge_t = std::uint32_t;
+
+      /*!
+       \class edge_ptr_t
+       \brief Edge of the snapshot, a value that stands for a pointer to edge in the outputters
+       */
+      class edge_ptr_t {
+      public:
+        edge_ptr_t(node_id_t src, node_id_t tgt, enum tchecker::covreach::edge_type_t type)
+        : _src(src), _tgt(tgt), _type(type)
+        {}
+
+        /*!
+         \brief Accessor
+         \return this, for the outputters that access edges through pointers
+         */
+        inline edge_ptr_t const * operator-> () const
+        {
+          return this;
+        }
+
+        inline node_id_t src() const
+        {
+          return _src;
+        }
+
+        inline node_id_t tgt() const
+        {
+          return _tgt;
+        }
+
+        inline enum tchecker::covreach::edge_type_t edge_type() const
+        {
+          return _type;
+        }
+
+        inline bool operator== (edge_ptr_t const & e) const
+        {
+          return (_src == e._src) && (_tgt == e._tgt) && (_type == e._type);
+        }
+
+        inline bool operator!= (edge_ptr_t const & e) const
+        {
+          return !(*this == e);
+        }
+
+      private:
+        node_id_t _src; /*! Id of the source node */
+        node_id_t _tgt; /*! Id of the target node */
+        enum tchecker::covreach::edge_type_t _type; /*! Type of the edge */
+      };
+
+      /*!
+       \class edge_iterator_t
+       \brief Iterator over the outgoing or incoming edges of a node
+       */
+      class edge_iterator_t {
+      public:
+        edge_iterator_t(node_id_t node, packed_edge_t const * it, bool outgoing)
+        : _node(node), _it(it), _outgoing(outgoing)
+        {}
+
+        inline edge_ptr_t operator* () const
+        {
+          return (_outgoing ? edge_ptr_t(_node, edge_node(*_it), edge_type(*_it)) :
+                  edge_ptr_t(edge_node(*_it), _node, edge_type(*_it)));
+        }
+
+        inline edge_iterator_t & operator++ ()
+        {
+          ++_it;
+          return *this;
+        }
+
+        inline bool operator== (edge_iterator_t const & it) const
+        {
+          return (_it == it._it);
+        }
+
+        inline bool operator!= (edge_iterator_t const & it) const
+        {
+          return (_it != it._it);
+        }
+
+      private:
+        node_id_t _node; /*! Node whose edges are iterated */
+        packed_edge_t const * _it; /*! Current packed edge */
+        bool _outgoing; /*! Whether the edges are outgoing edges of _node */
+      };
+
+      /*!
+       \class range_t
+       \brief Range of iterators
+       */
+      template <class IT>
+      class range_t {
+      public:
+        range_t(IT begin, IT end) : _begin(begin), _end(end)
+        {}
+
+        inline IT begin() const
+        {
+          return _begin;
+        }
+
+        inline IT end() const
+        {
+          return _end;
+        }
+
+      private:
+        IT _begin, _end;
+      };
+      
+      /*!
+       \brief Maximal number of nodes
+       */
+      static constexpr std::size_t max_nodes = std::size_t(1) << 31;
+
+      /*!
+       \brief Constructor
+       \post this is an empty graph
+       */
+      csr_graph_t() = default;
+
+      /*!
+       \brief Copy constructor (deleted)
+       */
+      csr_graph_t(tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> const &) = delete;
+
+      /*!
+       \brief Move constructor
+       */
+      csr_graph_t(tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> &&) = default;
+
+      /*!
+       \brief Destructor
+       */
+      ~csr_graph_t() = default;
+
+      /*!
+       \brief Assignment operator (deleted)
+       */
+      tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> const &) = delete;
+
+      /*!
+       \brief Move-assignment operator
+       */
+      tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::csr_graph_t<NODE_PTR> &&) = default;
+
+      /*!
+       \brief Build the snapshot
+       \tparam EDGE_VISITOR : callable as visit_outgoing(n, f) for any callable f with signature
+       void(node_ptr_t const &, enum tchecker::covreach::edge_type_t). It calls f(tgt, type) for every
+       outgoing edge n -> tgt
+       \param nodes : all the nodes of the graph, moved into this
+       \param visit_outgoing : visitor of the outgoing edges of a node
+       \param num_threads : number of threads used to build the adjacency arrays
+       \pre visit_outgoing does not modify the graph and can be called concurrently on distinct nodes.
+       Every target of an edge belongs to nodes
+       \post this holds the nodes and all the edges reported by visit_outgoing
+       \throw std::overflow_error : if nodes has max_nodes nodes or more
+       \note no reference counter is modified while the edges are visited
+       */
+      template <class EDGE_VISITOR>
+      void build(std::vector<node_ptr_t> && nodes, EDGE_VISITOR && visit_outgoing, unsigned int num_threads)
+      {
+        clear();
+        _nodes = std::move(nodes);
+
+        const std::size_t n_nodes = _nodes.size();
+        if (n_nodes >= max_nodes){
+          clear();
+          throw std::overflow_error("Too many nodes for a compact graph");
+        }
+        num_threads = std::max(1u, std::min<unsigned int>(num_threads, std::max<std::size_t>(n_nodes, 1)));
+
+        // Dense ids: sorted addresses allow concurrent lookups
+        _ids.clear();
+        _ids.reserve(n_nodes);
+        for (node_id_t i = 0; i < n_nodes; ++i){
+          _ids.emplace_back(static_cast<void const *>(_nodes[i].ptr()), i);
+        }
+        std::sort(_ids.begin(), _ids.end());
+
+        // 1) Out degrees
+        _out_offsets.assign(n_nodes+1, 0);
+        parallel_for(num_threads, n_nodes, [&](node_id_t i){
+          std::size_t degree = 0;
+          visit_outgoing(_nodes[i], [&degree](node_ptr_t const &, enum tchecker::covreach::edge_type_t){ ++degree; });
+          _out_offsets[i+1] = degree;
+        });
+        for (node_id_t i = 0; i < n_nodes; ++i){
+          _out_offsets[i+1] += _out_offsets[i];
+        }
+
+        // 2) Outgoing adjacency, in-degrees are counted on the fly
+        _out_edges.resize(_out_offsets[n_nodes]);
+        std::unique_ptr<std::atomic_size_t[]> in_count(new std::atomic_size_t[n_nodes+1]);
+        for (node_id_t i = 0; i <= n_nodes; ++i){
+          in_count[i].store(0, std::memory_order_relaxed);
+        }
+        parallel_for(num_threads, n_nodes, [&](node_id_t i){
+          std::size_t pos = _out_offsets[i];
+          visit_outgoing(_nodes[i], [&](node_ptr_t const & tgt, enum tchecker::covreach::edge_type_t type){
+            node_id_t tgt_id = id(tgt);
+            _out_edges[pos++] = pack(tgt_id, type);
+            in_count[tgt_id+1].fetch_add(1, std::memory_order_relaxed);
+          });
+        });
+
+        // 3) Incoming adjacency
+        _in_offsets.assign(n_nodes+1, 0);
+        for (node_id_t i = 0; i < n_nodes; ++i){
+          _in_offsets[i+1] = _in_offsets[i] + in_count[i+1].load(std::memory_order_relaxed);
+          in_count[i].store(_in_offsets[i], std::memory_order_relaxed); // Becomes the insertion cursor of node i
+        }
+        _in_edges.resize(_in_offsets[n_nodes]);
+        parallel_for(num_threads, n_nodes, [&](node_id_t i){
+          for (std::size_t k = _out_offsets[i]; k < _out_offsets[i+1]; ++k){
+            std::size_t pos = in_count[edge_node(_out_edges[k])].fetch_add(1, std::memory_order_relaxed);
+            _in_edges[pos] = pack(i, edge_type(_out_edges[k]));
+          }
+        });
+        // Deterministic order of the incoming edges
+        parallel_for(num_threads, n_nodes, [&](node_id_t i){
+          std::sort(_in_edges.begin()+_in_offsets[i], _in_edges.begin()+_in_offsets[i+1]);
+        });
+      }
+
+      /*!
+       \brief Clear the snapshot
+       \post all references to nodes have been released, this is empty
+       */
+      void clear()
+      {
+        _nodes.clear();
+        _ids.clear();
+        _out_offsets.clear();
+        _out_edges.clear();
+        _in_offsets.clear();
+        _in_edges.clear();
+      }
+
+      /*!
+       \brief Accessor
+       \return number of nodes
+       */
+      inline std::size_t nodes_count() const
+      {
+        return _nodes.size();
+      }
+
+      /*!
+       \brief Accessor
+       \return number of edges
+       */
+      inline std::size_t edges_count() const
+      {
+        return _out_edges.size();
+      }
+
+      /*!
+       \brief Accessor
+       \param i : node id
+       \return node with id i
+       */
+      inline node_ptr_t const & node(node_id_t i) const
+      {
+        return _nodes[i];
+      }
+
+      /*!
+       \brief Accessor
+       \param n : a node of this
+       \return id of n
+       \pre n belongs to this (checked by assertion)
+       */
+      inline node_id_t id(node_ptr_t const & n) const
+      {
+        auto it = std::lower_bound(_ids.begin(), _ids.end(),
+                                   std::make_pair(static_cast<void const *>(n.ptr()), node_id_t(0)));
+        assert((it != _ids.end()) && (it->first == static_cast<void const *>(n.ptr())));
+        return it->second;
+      }
+
+      /*!
+       \brief Accessor
+       \return range of the nodes, in id order
+       */
+      inline range_t<typename std::vector<node_ptr_t>::const_iterator> nodes() const
+      {
+        return range_t<typename std::vector<node_ptr_t>::const_iterator>(_nodes.begin(), _nodes.end());
+      }
+
+      /*!
+       \brief Accessor
+       \param n : a node of this
+       \return range of the outgoing edges of n
+       */
+      inline range_t<edge_iterator_t> outgoing_edges(node_ptr_t const & n) const
+      {
+        node_id_t const i = id(n);
+        return range_t<edge_iterator_t>(edge_iterator_t(i, out_begin(i), true), edge_iterator_t(i, out_end(i), true));
+      }
+
+      /*!
+       \brief Accessor
+       \param n : a node of this
+       \return range of the incoming edges of n
+       */
+      inline range_t<edge_iterator_t> incoming_edges(node_ptr_t const & n) const
+      {
+        node_id_t const i = id(n);
+        return range_t<edge_iterator_t>(edge_iterator_t(i, in_begin(i), false), edge_iterator_t(i, in_end(i), false));
+      }
+
+      /*!
+       \brief Accessor
+       \param e : an edge of this
+       \return source node of e
+       */
+      inline node_ptr_t const & edge_src(edge_ptr_t const & e) const
+      {
+        return _nodes[e.src()];
+      }
+
+      /*!
+       \brief Accessor
+       \param e : an edge of this
+       \return target node of e
+       */
+      inline node_ptr_t const & edge_tgt(edge_ptr_t const & e) const
+      {
+        return _nodes[e.tgt()];
+      }
+
+      /*!
+       \brief Accessors to the outgoing edges of node i
+       */
+      inline packed_edge_t const * out_begin(node_id_t i) const
+      {
+        return _out_edges.data() + _out_offsets[i];
+      }
+
+      inline packed_edge_t const * out_end(node_id_t i) const
+      {
+        return _out_edges.data() + _out_offsets[i+1];
+      }
+
+      /*!
+       \brief Accessors to the incoming edges of node i
+       */
+      inline packed_edge_t const * in_begin(node_id_t i) const
+      {
+        return _in_edges.data() + _in_offsets[i];
+      }
+
+      inline packed_edge_t const * in_end(node_id_t i) const
+      {
+        return _in_edges.data() + _in_offsets[i+1];
+      }
+
+      /*!
+       \brief Accessor
+       \param e : packed edge
+       \return id of the node at the other end of e
+       */
+      static inline node_id_t edge_node(packed_edge_t e)
+      {
+        return e >> 1;
+      }
+
+      /*!
+       \brief Accessor
+       \param e : packed edge
+       \return type of e
+       */
+      static inline enum tchecker::covreach::edge_type_t edge_type(packed_edge_t e)
+      {
+        return (e & 1) ? tchecker::covreach::ACTUAL_EDGE : tchecker::covreach::ABSTRACT_EDGE;
+      }
+
+    protected:
+
+      /*!
+       \brief Pack an edge
+       */
+      static inline packed_edge_t pack(node_id_t i, enum tchecker::covreach::edge_type_t type)
+      {
+        return static_cast<packed_edge_t>((i << 1) | (type == tchecker::covreach::ACTUAL_EDGE ? 1u : 0u));
+      }
+
+      /*!
+       \brief Apply f to all ids in [0, n), split in contiguous chunks over num_threads threads
+       */
+      template <class F>
+      static void parallel_for(unsigned int num_threads, std::size_t n, F && f)
+      {
+        if ((num_threads <= 1) || (n < 2*num_threads)){
+          for (std::size_t i = 0; i < n; ++i){
+            f(i);
+          }
+          return;
+        }
+        std::vector<std::thread> threads;
+        std::size_t chunk = (n + num_threads - 1)/num_threads;
+        for (unsigned int t = 0; t < num_threads; ++t){
+          std::size_t begin = t*chunk, end = std::min(n, begin+chunk);
+          if (begin >= end){
+            break;
+          }
+          threads.emplace_back([&f, begin, end](){
+            for (std::size_t i = begin; i < end; ++i){
+              f(i);
+            }
+          });
+        }
+        for (auto & th : threads){
+          th.join();
+        }
+      }
+
+      std::vector<node_ptr_t> _nodes; /*! Nodes, indexed by their dense id */
+      std::vector<std::pair<void const *, node_id_t>> _ids; /*! Address to id map, sorted by address */
+      std::vector<std::size_t> _out_offsets; /*! Offsets of outgoing edges, size nodes_count()+1 */
+      std::vector<packed_edge_t> _out_edges; /*! Outgoing edges (target id and type) */
+      std::vector<std::size_t> _in_offsets; /*! Offsets of incoming edges, size nodes_count()+1 */
+      std::vector<packed_edge_t> _in_edges; /*! Incoming edges (source id and type) */
+    };
+
+  }//covreach_ext
+}//tchecker_ext
+
+#endif //TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_CSR_GRAPH_HH
@@ -0,0 +1,423 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_EVICTION_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_EVICTION_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/functional/hash.hpp>
+
+#include "tchecker/dbm/dbm.hh"
+#include "tchecker/ta/details/state.hh"
+
+#include "tchecker_ext/utils/lock_stripes.hh"
+
+/*!
+ \file eviction.hh
+ \brief Eviction of cold passed nodes under a node payload budget
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class cold_node_evictor_t
+     \brief Passed nodes with the time they last covered a node, one table per stripe of the nodes table
+     \tparam NODE_PTR : type of pointer to node
+     \note Memory is the live bytes of the graph as measured by the graph (nodes, compressed zones, and the
+     bookkeeping of this evictor), not the resident memory of the process, that does not drop when nodes
+     are freed. The limit is thus a budget for the node payload, not a limit of the process: see
+     graph_t::live_bytes() for what is not counted. Pressure starts when the live bytes exceed the limit (high watermark), and lasts until they
+     drop below low_watermark of the limit. Under pressure, passed nodes that have not covered any node
+     since the previous pressure pass are cold: a cold node is first compressed (if zones can be
+     compressed), then evicted if it is still cold at the next pass. An evicted node is removed from the
+     graph. This is sound for reachability: a node that would have been covered by an evicted node is
+     explored again. A pass that frees nothing stops the passes until the live bytes have grown by the
+     gap between the watermarks.
+     \note The fingerprints of (at most max_fingerprints_share of the limit worth of) evicted nodes are
+     kept to count the nodes explored again. The tables of a stripe are only accessed under the lock of
+     this stripe
+     */
+    template <class NODE_PTR>
+    class cold_node_evictor_t {
+    public:
+      /*!
+       \brief Type of nodes
+       */
+      using node_t = std::remove_reference_t<decltype(*std::declval<NODE_PTR const &>())>;
+
+      /*!
+       \brief Minimal time between two pressure passes
+       */
+      static constexpr std::chrono::milliseconds check_interval{100};
+
+      /*!
+       \brief End of pressure, as a fraction of the limit
+       */
+      static constexpr double low_watermark = 0.9;
+
+      /*!
+       \brief Memory for the fingerprints of evicted nodes, as a fraction of the limit
+       */
+      static constexpr double max_fingerprints_share = 1.0 / 64;
+
+      /*!
+       \brief Estimated memory of a passed node entry (bytes, node of the hash table included)
+       */
+      static constexpr std::size_t passed_entry_bytes = sizeof(node_t *) + 2 * sizeof(std::size_t) + 3 * sizeof(void *);
+
+      /*!
+       \brief Estimated memory of a fingerprint entry (bytes, node of the hash table included)
+       */
+      static constexpr std::size_t fingerprint_entry_bytes = sizeof(std::size_t) + 3 * sizeof(void *);
+
+      /*!
+       \brief Constructor
+       \param limit : memory limit (bytes)
+       \post this has no table, see init()
+       */
+      explicit cold_node_evictor_t(std::size_t limit)
+      : _limit(limit),
+        _low(static_cast<std::size_t>(low_watermark * limit)),
+        _pass(0),
+        _busy(false),
+        _last_check(std::chrono::steady_clock::now() - check_interval)
+      {}
+
+      cold_node_evictor_t(tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> const &) = delete;
+      cold_node_evictor_t(tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> &&) = delete;
+      ~cold_node_evictor_t() = default;
+      tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> const &) = delete;
+      tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::cold_node_evictor_t<NODE_PTR> &&) = delete;
+
+      /*!
+       \brief Initialization
+       \param n_stripes : number of stripes of the nodes table
+       \post this has n_stripes empty tables
+       \note called by the graph that stores the nodes
+       */
+      void init(std::size_t n_stripes)
+      {
+        assert(n_stripes > 0);
+        _n_stripes = n_stripes;
+        _tables.reset(new tchecker_ext::cache_aligned_t<stripe_table_t>[n_stripes]);
+        std::size_t const fingerprints = static_cast<std::size_t>(max_fingerprints_share * _limit) / fingerprint_entry_bytes;
+        _max_fingerprints = std::max<std::size_t>(1, fingerprints / n_stripes);
+      }
+
+      /*!
+       \brief Accessor
+       \return number of stripes
+       */
+      inline std::size_t n_stripes() const
+      {
+        return _n_stripes;
+      }
+
+      /*!
+       \brief Fingerprint
+       \param node : a node with a dense zone
+       \return hash value of the discrete part and the zone of node
+       */
+      static std::size_t fingerprint(NODE_PTR const & node)
+      {
+        std::size_t h = tchecker::ta::details::hash_value(*node);
+        boost::hash_combine(h, tchecker::dbm::hash(node->zone().dbm(), node->zone().dim()));
+        return h;
+      }
+
+      /*!
+       \brief Record a passed node
+       \param stripe : stripe of node
+       \param node : a node that has just been expanded, with a dense zone
+       \pre stripe is locked by the caller
+       \post node is a passed node, hit now
+       */
+      void passed(std::size_t stripe, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        if (_tables[stripe].value.passed.emplace(node.ptr(), entry_t{_pass.load(std::memory_order_relaxed), fingerprint(node)}).second)
+          _n_passed.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Record a hit
+       \param stripe : stripe of node
+       \param node : a node that has covered some node
+       \pre stripe is locked by the caller
+       \post node is hit now if it is a passed node
+       */
+      void hit(std::size_t stripe, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        auto it = _tables[stripe].value.passed.find(node.ptr());
+        if (it != _tables[stripe].value.passed.end())
+          it->second.last_hit = _pass.load(std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Record an insertion
+       \param stripe : stripe of node
+       \param node : a node inserted in the graph, with a dense zone
+       \pre stripe is locked by the caller
+       \post if node has the fingerprint of an evicted node, it is counted as explored again and the
+       fingerprint is forgotten
+       */
+      void inserted(std::size_t stripe, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        stripe_table_t & table = _tables[stripe].value;
+        if (table.evicted.empty())
+          return;
+        if (table.evicted.erase(fingerprint(node)) != 0) {
+          ++table.reexplored;
+          _n_fingerprints.fetch_sub(1, std::memory_order_relaxed);
+        }
+      }
+
+      /*!
+       \brief Record a relocation
+       \param stripe : stripe of node
+       \param node : a node
+       \param moved : copy of node that replaces node in the graph
+       \pre stripe is locked by the caller (or no other thread accesses this)
+       \post if node is a passed node, moved is a passed node with the same last hit and fingerprint, and
+       node is not a passed node anymore
+       */
+      void relocated(std::size_t stripe, NODE_PTR const & node, NODE_PTR const & moved)
+      {
+        assert(stripe < _n_stripes);
+        auto & passed = _tables[stripe].value.passed;
+        auto it = passed.find(node.ptr());
+        if (it == passed.end())
+          return;
+        entry_t const entry = it->second;
+        passed.erase(it);
+        passed.emplace(moved.ptr(), entry);
+      }
+
+      /*!
+       \brief Erase
+       \param stripe : stripe of node
+       \param node : a node
+       \pre stripe is locked by the caller
+       \post node is not a passed node anymore
+       */
+      void erase(std::size_t stripe, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        if (_tables[stripe].value.passed.erase(node.ptr()) != 0)
+          _n_passed.fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Start a pressure pass
+       \param live_bytes : live bytes of the graph (see bookkeeping_bytes())
+       \return true if the calling thread has to run a pressure pass, false otherwise
+       \note at most one thread runs a pressure pass at a time, and passes are at least check_interval
+       apart. A pass is due under pressure, unless the previous pass has freed nothing and live_bytes has
+       not grown by the gap between the watermarks since. The pass has to be terminated by end_pass()
+       \note thread safe
+       */
+      bool begin_pass(std::size_t live_bytes)
+      {
+        if (_busy.exchange(true, std::memory_order_acquire))
+          return false;
+        if (live_bytes > _limit)
+          _pressure = true;
+        else if (live_bytes < _low) {
+          _pressure = false;
+          _stalled_below = 0;
+        }
+        auto const now = std::chrono::steady_clock::now();
+        if (_pressure && (live_bytes > _stalled_below) && (now - _last_check >= check_interval)) {
+          _last_check = now;
+          _pass.fetch_add(1, std::memory_order_relaxed);
+          _freed_in_pass = 0;
+          ++_pressure_passes;
+          return true;
+        }
+        _busy.store(false, std::memory_order_release);
+        return false;
+      }
+
+      /*!
+       \brief Terminate a pressure pass
+       \param live_bytes : live bytes of the graph after the pass
+       \pre begin_pass() has returned true to the calling thread
+       \post if the pass has freed nothing, no pass is due before live bytes exceed live_bytes by the gap
+       between the watermarks
+       */
+      void end_pass(std::size_t live_bytes)
+      {
+        _stalled_below = (_freed_in_pass == 0 ? live_bytes + (_limit - _low) : 0);
+        _busy.store(false, std::memory_order_release);
+      }
+
+      /*!
+       \brief Accessor
+       \return estimated memory of the tables of this (bytes)
+       \note thread safe
+       */
+      std::size_t bookkeeping_bytes() const
+      {
+        return _n_passed.load(std::memory_order_relaxed) * passed_entry_bytes
+        + _n_fingerprints.load(std::memory_order_relaxed) * fingerprint_entry_bytes;
+      }
+
+      /*!
+       \brief Sweep a stripe
+       \param stripe : a stripe
+       \param compress : function called on cold nodes, returns true if the node has been compressed, false
+       if it could not be compressed (already compressed, or zones are not compressed)
+       \param evict : function called on cold nodes that could not be compressed, removes the node from the
+       graph and releases the given reference
+       \pre stripe is locked by the caller, the calling thread runs a pressure pass
+       \post active cold nodes of stripe have been compressed or evicted. The evicted nodes are not passed
+       nodes anymore and their fingerprints have been kept, as long as the table of fingerprints of stripe
+       is not full
+       */
+      template <class COMPRESS, class EVICT>
+      void sweep(std::size_t stripe, COMPRESS && compress, EVICT && evict)
+      {
+        assert(stripe < _n_stripes);
+        stripe_table_t & table = _tables[stripe].value;
+        std::size_t const pass = _pass.load(std::memory_order_relaxed);
+        for (auto it = table.passed.begin(); it != table.passed.end(); ) {
+          // Covered nodes are erased when released. Nodes hit since the previous pass are not cold
+          if (!it->first->is_active() || (it->second.last_hit + 1 >= pass)) {
+            ++it;
+            continue;
+          }
+          NODE_PTR node{it->first};
+          if (compress(node)) {
+            ++_compressed;
+            ++_freed_in_pass;
+            ++it;
+            continue;
+          }
+          if ((table.evicted.size() < _max_fingerprints) && table.evicted.insert(it->second.fingerprint).second)
+            _n_fingerprints.fetch_add(1, std::memory_order_relaxed);
+          it = table.passed.erase(it); // Before evict(), that may release the last reference to node
+          _n_passed.fetch_sub(1, std::memory_order_relaxed);
+          evict(node);
+          ++_evicted;
+          ++_freed_in_pass;
+        }
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this
+       \post all tables are empty
+       */
+      void clear()
+      {
+        for (std::size_t s = 0; s < _n_stripes; ++s) {
+          _tables[s].value.passed.clear();
+          _tables[s].value.evicted.clear();
+        }
+        _n_passed.store(0, std::memory_order_relaxed);
+        _n_fingerprints.store(0, std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return number of pressure passes
+       */
+      inline std::size_t pressure_passes() const
+      {
+        return _pressure_passes;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of nodes compressed by pressure passes
+       */
+      inline std::size_t compressed() const
+      {
+        return _compressed;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of evicted nodes
+       */
+      inline std::size_t evicted() const
+      {
+        return _evicted;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of inserted nodes with the fingerprint of an evicted node
+       \pre no other thread modifies this
+       \note a lower bound once the table of fingerprints of some stripe has been full
+       */
+      std::size_t reexplored() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          n += _tables[s].value.reexplored;
+        return n;
+      }
+
+    private:
+      /*!
+       \class entry_t
+       \brief Passed node
+       */
+      struct entry_t {
+        std::size_t last_hit;     /*!< Pass of the last hit */
+        std::size_t fingerprint;  /*!< Fingerprint */
+      };
+
+      /*!
+       \class stripe_table_t
+       \brief Passed and evicted nodes of one stripe
+       */
+      struct stripe_table_t {
+        std::unordered_map<node_t *, entry_t> passed; /*!< Passed nodes */
+        std::unordered_set<std::size_t> evicted; /*!< Fingerprints of evicted nodes */
+        std::size_t reexplored = 0; /*!< Number of inserted nodes with the fingerprint of an evicted node */
+      };
+
+      std::size_t const _limit; /*!< Memory limit, high watermark (bytes) */
+      std::size_t const _low; /*!< Low watermark (bytes) */
+      std::atomic<std::size_t> _pass; /*!< Current pass */
+      std::atomic_bool _busy; /*!< Whether a thread checks or relieves memory pressure */
+      std::chrono::steady_clock::time_point _last_check; /*!< Time of the last pass (protected by _busy) */
+      bool _pressure = false; /*!< Whether memory is under pressure (protected by _busy) */
+      std::size_t _stalled_below = 0; /*!< Live bytes up to which no pass is due after a pass that freed nothing (protected by _busy) */
+      std::size_t _freed_in_pass = 0; /*!< Number of nodes compressed or evicted by the current pass (protected by _busy) */
+      std::atomic<std::size_t> _n_passed{0}; /*!< Number of passed nodes */
+      std::atomic<std::size_t> _n_fingerprints{0}; /*!< Number of fingerprints of evicted nodes */
+      std::size_t _max_fingerprints = 1; /*!< Maximal number of fingerprints per stripe */
+      std::size_t _pressure_passes = 0; /*!< Number of pressure passes (protected by _busy) */
+      std::size_t _compressed = 0; /*!< Number of nodes compressed by pressure passes (protected by _busy) */
+      std::size_t _evicted = 0; /*!< Number of evicted nodes (protected by _busy) */
+      std::size_t _n_stripes = 0; /*!< Number of stripes */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<stripe_table_t>[]> _tables; /*!< One table per stripe */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_EVICTION_HH
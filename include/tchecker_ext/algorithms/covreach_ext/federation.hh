@@ -0,0 +1,224 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_FEDERATION_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_FEDERATION_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/dbm.hh"
+#include "tchecker_ext/utils/lock_stripes.hh"
+
+/*!
+ \file federation.hh
+ \brief Covering by the union of the zones of the stored nodes with the same discrete part
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class federation_store_t
+     \brief Stored nodes by discrete part, one table per stripe of the nodes table
+     \tparam NODE_PTR : type of pointer to node
+     \note The zones of the active stored nodes with the same discrete part form a federation. A node that
+     is not included in any of these zones may still be included in their union: it is then covered as well,
+     since every state reachable from it is reachable from a stored node. There is no single covering node,
+     hence covering by a federation is only used when the graph stores no edges.
+     Nodes with the same discrete part are in the same stripe. The table of a stripe is only accessed under
+     the lock of this stripe
+     */
+    template <class NODE_PTR>
+    class federation_store_t {
+    public:
+      /*!
+       \brief Type of nodes
+       */
+      using node_t = std::remove_reference_t<decltype(*std::declval<NODE_PTR const &>())>;
+
+      /*!
+       \brief Bound on the number of pieces of the difference between a zone and a federation, above which
+       the zone is not covered
+       */
+      static constexpr std::size_t max_pieces = 64;
+
+      /*!
+       \brief Constructor
+       \post this has no table, see init()
+       */
+      federation_store_t() = default;
+
+      federation_store_t(tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> const &) = delete;
+      federation_store_t(tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> &&) = delete;
+      ~federation_store_t() = default;
+      tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> const &) = delete;
+      tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::federation_store_t<NODE_PTR> &&) = delete;
+
+      /*!
+       \brief Initialization
+       \param n_stripes : number of stripes of the nodes table
+       \post this has n_stripes empty tables
+       \note called by the graph that stores the nodes
+       */
+      void init(std::size_t n_stripes)
+      {
+        assert(n_stripes > 0);
+        _n_stripes = n_stripes;
+        _tables.reset(new tchecker_ext::cache_aligned_t<stripe_table_t>[n_stripes]);
+      }
+
+      /*!
+       \brief Covering by a federation
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node with a dense tight zone, not stored yet, not included in the zone of any stored node
+       \param zones : scratch vector
+       \param pieces : scratch vector
+       \param next : scratch vector
+       \pre stripe is locked by the caller
+       \return true if the zone of node is included in the union of the zones of the active stored nodes with
+       the discrete part of node and a dense zone (compressed zones are skipped), false otherwise
+       */
+      bool covered(std::size_t stripe, std::size_t key, NODE_PTR const & node,
+                   std::vector<tchecker::dbm::db_t const *> & zones,
+                   std::vector<tchecker::dbm::db_t> & pieces, std::vector<tchecker::dbm::db_t> & next)
+      {
+        assert(stripe < _n_stripes);
+        stripe_table_t & table = _tables[stripe].value;
+        auto it = table.nodes.find(key);
+        // A single zone covers by inclusion
+        if ((it == table.nodes.end()) || (it->second.size() < 2))
+          return false;
+
+        zones.clear();
+        for (node_t * m : it->second) {
+          if (!m->is_active() || (m->zone_ptr().ptr() == nullptr))
+            continue;
+          if ((m->vloc() != node->vloc()) || (m->intvars_valuation() != node->intvars_valuation()))
+            continue;
+          zones.push_back(m->zone().dbm());
+        }
+        if (zones.size() < 2)
+          return false;
+
+        if (!tchecker_ext::dbm_ext::is_le_union(node->zone().dbm(), zones.data(), zones.size(), node->zone().dim(),
+                                                pieces, next, max_pieces))
+          return false;
+        ++table.covered;
+        return true;
+      }
+
+      /*!
+       \brief Record an insertion
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node inserted in the graph
+       \pre stripe is locked by the caller
+       \post the zone of node is in the federation of its discrete part
+       */
+      void inserted(std::size_t stripe, std::size_t key, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        _tables[stripe].value.nodes[key].push_back(node.ptr());
+      }
+
+      /*!
+       \brief Record a relocation
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node
+       \param moved : copy of node that replaces node in the graph
+       \pre stripe is locked by the caller (or no other thread accesses this)
+       \post if the zone of node was in a federation, moved has replaced node
+       */
+      void relocated(std::size_t stripe, std::size_t key, NODE_PTR const & node, NODE_PTR const & moved)
+      {
+        assert(stripe < _n_stripes);
+        auto it = _tables[stripe].value.nodes.find(key);
+        if (it == _tables[stripe].value.nodes.end())
+          return;
+        std::replace(it->second.begin(), it->second.end(), node.ptr(), moved.ptr());
+      }
+
+      /*!
+       \brief Erase
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node
+       \pre stripe is locked by the caller
+       \post the zone of node is not in a federation anymore
+       */
+      void erase(std::size_t stripe, std::size_t key, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        auto & nodes = _tables[stripe].value.nodes;
+        auto it = nodes.find(key);
+        if (it == nodes.end())
+          return;
+        auto pos = std::find(it->second.begin(), it->second.end(), node.ptr());
+        if (pos == it->second.end())
+          return;
+        *pos = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty())
+          nodes.erase(it);
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this
+       \post all tables are empty
+       */
+      void clear()
+      {
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          _tables[s].value.nodes.clear();
+      }
+
+      /*!
+       \brief Accessor
+       \return number of nodes covered by a federation
+       \pre no other thread modifies this
+       */
+      std::size_t covered_count() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          n += _tables[s].value.covered;
+        return n;
+      }
+
+    private:
+      /*!
+       \class stripe_table_t
+       \brief Stored nodes of one stripe
+       */
+      struct stripe_table_t {
+        std::unordered_map<std::size_t, std::vector<node_t *>> nodes; /*!< Stored nodes by hash value of their discrete part */
+        std::size_t covered = 0; /*!< Number of nodes covered by a federation */
+      };
+
+      std::size_t _n_stripes = 0; /*!< Number of stripes */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<stripe_table_t>[]> _tables; /*!< One table per stripe */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_FEDERATION_HH
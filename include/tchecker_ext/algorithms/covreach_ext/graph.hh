@@ -5,13 +5,27 @@
 #ifndef TCHECKER_EXT_GRAPH_HH
 #define TCHECKER_EXT_GRAPH_HH
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
 #include <list>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "tchecker/algorithms/covreach/graph.hh"
 
+#include "tchecker_ext/algorithms/covreach_ext/compressed_zones.hh"
+#include "tchecker_ext/algorithms/covreach_ext/csr_graph.hh"
+#include "tchecker_ext/algorithms/covreach_ext/eviction.hh"
+#include "tchecker_ext/algorithms/covreach_ext/federation.hh"
+#include "tchecker_ext/algorithms/covreach_ext/intern.hh"
+#include "tchecker_ext/algorithms/covreach_ext/merge.hh"
+#include "tchecker_ext/algorithms/covreach_ext/packed_discrete.hh"
 #include "tchecker_ext/algorithms/covreach_ext/waiting.hh"
+#include "tchecker_ext/utils/lock_stripes.hh"
+#include "tchecker_ext/utils/shared_objects.hh"
 #include "tchecker_ext/utils/spinlock.hh"
 
 #include <tchecker_ext/config.hh>
@@ -32,10 +46,17 @@ namespace tchecker_ext{
      \tparam KEY
      \tparam TS
      \tparam TS_ALLOCATOR
+     \tparam LOCK : type of the bucket locks, tchecker_ext::null_lock_t if the graph is only
+     accessed by a single thread
      */
-    template <class KEY, class TS, class TS_ALLOCATOR>
+    template <class KEY, class TS, class TS_ALLOCATOR, class LOCK=tchecker_ext::spinlock_t>
     class graph_t: public tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>{
     public:
+      /*!
+       \brief Type of the bucket locks
+       */
+      using lock_t = LOCK;
+      
   
       /*!
        \brief Type of pointers to node
@@ -49,17 +70,395 @@ namespace tchecker_ext{
       using dir_graph_t = typename tchecker::graph::directed::graph_t<node_ptr_t, edge_ptr_t>;
       using cov_graph_t = typename tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>;;
       using tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_all_nodes;
+      
+      /*!
+       \brief Type of node allocator
+       */
+      using state_allocator_t = typename TS_ALLOCATOR::state_allocator_t;
+      
+      /*!
+       \brief Type of edge allocator
+       */
+      using edge_allocator_t = std::remove_reference_t<decltype(cov_graph_t::_edge_allocator)>;
+      
+      /*!
+       \brief Type of shared pointer to zone
+       */
+      using zone_ptr_t = typename tchecker_ext::covreach_ext::zone_intern_table_t<node_ptr_t, LOCK>::zone_ptr_t;
+      
+      /*!
+       \brief Minimal number of nodes stored and removed since the last compaction for a compaction
+       to be due
+       */
+      static constexpr std::size_t compaction_min_nodes = 1 << 16;
+      
+      /*!
+       \brief Whether the reference counters of the nodes are atomic (see tchecker_ext::make_atomic_shared_t)
+       */
+      static constexpr bool atomic_refcount =
+          tchecker_ext::is_atomic_shared_t<std::remove_reference_t<decltype(*std::declval<node_ptr_t const &>())>>::value;
   
+      /*!
+       \brief Constructor
+       \param gc : garbage collector
+       \param ts_alloc_args : arguments to a constructor of TS_ALLOCATOR
+       \param block_size : number of objects allocated in a block
+       \param table_size : size of the nodes table
+       \param n_lock_stripes : number of locks protecting the buckets of the nodes table, one lock per bucket if 0
+       \param node_to_key : function from nodes to keys
+       \param le_node : covering predicate over nodes
+       \param store_edges : whether edges are stored or only the set of passed nodes is kept
+       \param intern_discrete : whether stored nodes share equal discrete parts
+       \param intern_zones : whether stored nodes share equal zones
+       \param compressed_zones : store of the compressed zones of passed nodes, nullptr if zones are not
+       compressed. le_node must decide covering on compressed zones from this store
+       \param compress_expanded : whether zones are compressed as soon as nodes have been expanded, or only
+       under memory pressure (ignored if compressed_zones is nullptr)
+       \param evictor : passed nodes evicted under a memory limit, nullptr if memory is not limited. Nodes
+       are only compressed under pressure if compressed_zones is not nullptr
+       \note if store_edges is false, no edge is ever allocated and covering does not move edges.
+       Only the reachability of accepting nodes can be decided from such a graph
+       */
       template <class ... ARGS>
       graph_t(tchecker::gc_t & gc,
               std::tuple<ARGS...> && ts_alloc_args,
               std::size_t block_size,
               std::size_t table_size,
+              std::size_t n_lock_stripes,
               typename tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::node_to_key_t node_to_key,
-              typename tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::node_binary_predicate_t le_node)
-              : tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>(gc, std::forward<std::tuple<ARGS...>>(ts_alloc_args), block_size, table_size, node_to_key, le_node)
+              typename tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::node_binary_predicate_t le_node,
+              bool store_edges=true,
+              bool intern_discrete=false,
+              bool intern_zones=false,
+              std::shared_ptr<tchecker_ext::covreach_ext::compressed_zone_store_t<node_ptr_t>> compressed_zones=nullptr,
+              bool compress_expanded=true,
+              std::shared_ptr<tchecker_ext::covreach_ext::cold_node_evictor_t<node_ptr_t>> evictor=nullptr)
+              : tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>(gc, std::forward<std::tuple<ARGS...>>(ts_alloc_args), block_size, table_size, node_to_key, le_node),
+                _container_locks(n_lock_stripes == 0 ? table_size : n_lock_stripes),
+                _store_edges(store_edges),
+                _intern_discrete(intern_discrete),
+                _discrete_table(intern_discrete ? _container_locks.size() : 1),
+                _intern_zones(intern_zones),
+                _zone_table(intern_zones ? _container_locks.size() : 1),
+                _compressed_zones(compressed_zones),
+                _compress_expanded(compressed_zones && compress_expanded),
+                _evictor(evictor)
+        {
+          if (_compressed_zones){
+            _compressed_zones->init(_container_locks.size());
+          }
+          if (_evictor){
+            _evictor->init(_container_locks.size());
+          }
+        }
+        
+        /*!
+         \brief Accessor
+         \return true if stored nodes share equal discrete parts, false otherwise
+         */
+        inline bool intern_discrete() const
+        {
+          return _intern_discrete;
+        }
+        
+        /*!
+         \brief Accessor
+         \return table of the canonical discrete parts of the stored nodes
+         */
+        inline tchecker_ext::covreach_ext::discrete_intern_table_t<node_ptr_t> const & discrete_table() const
+        {
+          return _discrete_table;
+        }
+        
+        /*!
+         \brief Set discrete packer
+         \param packer : layout of packed discrete parts (enabled), nullptr to compare discrete parts as they are
+         \pre no node has been stored
+         \post if stored nodes share equal discrete parts, canonical discrete parts are found from their
+         encoding by packer
+         \note the keys of the nodes are given by node_to_key (see constructor), the packed discrete parts
+         should also be used there
+         */
+        void set_discrete_packer(std::shared_ptr<tchecker_ext::covreach_ext::discrete_packer_t const> packer)
+        {
+          _packer = packer;
+          if (_intern_discrete){
+            _discrete_table.set_packer(_packer.get());
+          }
+        }
+        
+        /*!
+         \brief Accessor
+         \return layout of packed discrete parts, nullptr if discrete parts are not packed
+         */
+        inline std::shared_ptr<tchecker_ext::covreach_ext::discrete_packer_t const> const & discrete_packer() const
+        {
+          return _packer;
+        }
+        
+        /*!
+         \brief Set zone merger
+         \param merger : stored nodes by discrete part, nullptr if zones are not merged
+         \pre no node has been stored
+         \post if merger is not nullptr, the zone of a node inserted by build_and_insert() is merged with the
+         zones of stored nodes with the same discrete part whenever their union is convex. These nodes are then
+         covered by the inserted node (see tchecker_ext::covreach_ext::zone_merger_t)
+         */
+        void set_zone_merger(std::shared_ptr<tchecker_ext::covreach_ext::zone_merger_t<node_ptr_t>> merger)
         {
-          _container_locks = std::vector<tchecker_ext::spinlock_t>(table_size);
+          _merger = merger;
+          if (_merger){
+            _merger->init(_container_locks.size());
+          }
+        }
+        
+        /*!
+         \brief Set federation store
+         \param federations : stored nodes by discrete part, nullptr if nodes are not covered by federations
+         \pre no node has been stored, the graph stores no edges
+         \post if federations is not nullptr, a node inserted by build_and_insert() that is not included in the zone
+         of a stored node is still covered if it is included in the union of the zones of the stored nodes with the
+         same discrete part (see tchecker_ext::covreach_ext::federation_store_t)
+         */
+        void set_federation_store(std::shared_ptr<tchecker_ext::covreach_ext::federation_store_t<node_ptr_t>> federations)
+        {
+          assert(!federations || !_store_edges);
+          _federations = federations;
+          if (_federations){
+            _federations->init(_container_locks.size());
+          }
+        }
+        
+        /*!
+         \brief Accessor
+         \return true if stored nodes share equal zones, false otherwise
+         */
+        inline bool intern_zones() const
+        {
+          return _intern_zones;
+        }
+        
+        /*!
+         \brief Accessor
+         \return table of the canonical zones of the stored nodes
+         */
+        inline tchecker_ext::covreach_ext::zone_intern_table_t<node_ptr_t, LOCK> const & zone_table() const
+        {
+          return _zone_table;
+        }
+        
+        /*!
+         \brief Enable per-worker edge arenas
+         \param gc : garbage collector
+         \param n_workers : number of workers
+         \param block_size : number of edges allocated in a block
+         \pre no edge has been stored
+         \post this owns n_workers edge allocators enrolled to gc. The edges added by build_and_insert() are
+         allocated from the arena of the calling worker (see working_elements::worker), hence edge allocation
+         never contends with other workers
+         \note edges are never freed by the worker dropping their last reference, the garbage collector
+         returns them to the arena they come from
+         */
+        void enable_edge_arenas(tchecker::gc_t & gc, unsigned int n_workers, std::size_t block_size)
+        {
+          assert(_store_edges);
+          _n_edge_arenas = n_workers;
+          _edge_arenas.reset(new tchecker_ext::cache_aligned_t<std::unique_ptr<edge_allocator_t>>[n_workers]);
+          for (unsigned int w = 0; w < n_workers; ++w){
+            _edge_arenas[w].value.reset(new edge_allocator_t(block_size));
+            _edge_arenas[w].value->enroll(gc);
+          }
+        }
+        
+        /*!
+         \brief Enable compaction of the nodes
+         \param gc : garbage collector
+         \param sa_args : arguments to a constructor of the node allocator
+         \param threshold : fraction of nodes removed since the last compaction above which a compaction
+         is due, in (0, 1)
+         \post this owns two node arenas built from sa_args and enrolled to gc. The stored nodes are
+         relocated to these arenas in turn, see compact()
+         */
+        template <class ... SA_ARGS>
+        void enable_compaction(tchecker::gc_t & gc, std::tuple<SA_ARGS...> && sa_args, double threshold)
+        {
+          assert((threshold > 0.0) && (threshold < 1.0));
+          _compaction_threshold = threshold;
+          _gc = &gc;
+          for (std::unique_ptr<state_allocator_t> & arena : _compaction_arenas){
+            arena.reset(std::apply([] (auto && ... a) { return new state_allocator_t(a...); }, sa_args));
+            arena->enroll(gc);
+          }
+        }
+        
+        /*!
+         \brief Accessor
+         \return true if a compaction is due, false otherwise
+         \note thread safe. The fraction of removed nodes is an estimate of the fraction of dead slots
+         in the node pools: the slots of removed nodes are reused by nodes of other buckets
+         */
+        inline bool compaction_due() const
+        {
+          if (_compaction_threshold == 0.0){
+            return false;
+          }
+          std::size_t const dead = _dead_nodes.load(std::memory_order_relaxed);
+          std::size_t const total = _compacted_nodes + _inserted_nodes.load(std::memory_order_relaxed);
+          return (total >= compaction_min_nodes) && (static_cast<double>(dead) > _compaction_threshold * total);
+        }
+        
+        /*!
+         \brief Accessor
+         \return number of compactions
+         */
+        inline std::size_t compactions() const
+        {
+          return _n_compactions;
+        }
+        
+        /*!
+         \brief Accessor
+         \return number of nodes relocated by compactions
+         */
+        inline std::size_t relocated_nodes() const
+        {
+          return _relocated_nodes;
+        }
+        
+        /*!
+         \brief Compaction
+         \pre compaction is enabled. No other thread accesses the graph (stop-the-world), and no thread
+         holds a reference to a stored node apart from waiting containers
+         \post the stored nodes that are only referenced by the graph have been relocated to a node arena,
+         bucket after bucket, so that the nodes of a bucket are contiguous. Their edges have been moved to
+         the relocated nodes. Nodes that are still waiting, or whose zone is compressed are not
+         relocated (waiting nodes will be relocated by a later compaction once they have been expanded).
+         The arena that receives the nodes has first been freed if all the nodes it got two compactions
+         ago have been destructed (they have been relocated to the other arena by the previous compaction)
+         \note the garbage collector is stopped while the drained arena is freed. Shared parts are never
+         allocated from an arena: the parts of a relocated node are replaced by the canonical parts it was
+         sharing
+         */
+        void compact()
+        {
+          assert(_compaction_threshold > 0.0);
+          unsigned int const current = _n_compactions % 2;
+          // Nodes are counted until the garbage collector destructs them
+          if ((_n_compactions > 1) && (_compaction_arena_nodes[current].load(std::memory_order_relaxed) == 0)){
+            _gc->stop();
+            _compaction_arenas[current]->free_all();
+            _gc->start();
+          }
+          std::vector<node_ptr_t> nodes;
+          get_all_nodes(nodes); // In table order
+          for (node_ptr_t & node : nodes){
+            std::size_t const stripe =
+                _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(node));
+            if (relocate(stripe, node, current)){
+              ++_relocated_nodes;
+            }
+            release(stripe, node);
+          }
+          _compacted_nodes = nodes.size();
+          _inserted_nodes.store(0, std::memory_order_relaxed);
+          _dead_nodes.store(0, std::memory_order_relaxed);
+          ++_n_compactions;
+        }
+        
+        /*!
+         \brief Fast memory deallocation
+         \pre see tchecker::covreach::graph_t::free_all()
+         \post all nodes and edges, and the node arenas of compaction, have been freed
+         */
+        void free_all()
+        {
+          cov_graph_t::free_all();
+          for (std::unique_ptr<state_allocator_t> & arena : _compaction_arenas){
+            if (arena){
+              arena->free_all();
+            }
+          }
+          for (unsigned int w = 0; w < _n_edge_arenas; ++w){
+            _edge_arenas[w].value->free_all();
+          }
+        }
+        
+        /*!
+         \brief Clear
+         \pre no other thread accesses the graph, the garbage collector is stopped
+         \post the graph and the tables of canonical discrete parts and zones are empty
+         */
+        void clear()
+        {
+          _discrete_table.clear();
+          _zone_table.clear();
+          if (_compressed_zones){
+            _compressed_zones->clear();
+          }
+          if (_evictor){
+            _evictor->clear();
+          }
+          if (_merger){
+            _merger->clear();
+          }
+          if (_federations){
+            _federations->clear();
+          }
+          cov_graph_t::clear();
+        }
+        
+        /*!
+         \brief Parallel clear
+         \param num_threads : number of threads
+         \pre no other thread accesses the graph, the garbage collector is stopped
+         \post same as clear()
+         \note Only in reachability-only mode (no edges stored), with several threads: the nodes are taken out
+         of the buckets of the graph first (sequentially, they are kept alive by the caller). Then each thread
+         releases the nodes of its own set of stripes, which clears their entries in the side tables of these
+         stripes (compressed zones, evictor, merger, federations, canonical discrete parts). Canonical zones
+         are released under the locks of their shards. Without edges, no node is referenced from another
+         stripe, so threads never touch the same node or side table
+         \note With stored edges, or a single thread, this is clear(): edges link nodes of different stripes
+         */
+        void clear(unsigned int num_threads)
+        {
+          if (_store_edges || (num_threads <= 1)){
+            clear();
+            return;
+          }
+          std::vector<node_ptr_t> nodes;
+          get_all_nodes(nodes);
+          // Indices of the nodes of each thread, with their stripes, while the nodes are still in the buckets
+          std::vector<std::vector<std::pair<std::size_t, std::size_t>>> shares(num_threads);
+          for (std::size_t i=0; i<nodes.size(); ++i){
+            std::size_t const stripe =
+                _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(nodes[i]));
+            shares[stripe % num_threads].emplace_back(i, stripe);
+          }
+          // From now on, nodes holds the last reference to every stored node
+          cov_graph_t::clear();
+          std::vector<std::thread> threads;
+          for (unsigned int t=0; t<num_threads; ++t){
+            threads.emplace_back([this, &nodes, &share = shares[t]] () {
+              for (auto const & [i, stripe] : share){
+                release(stripe, nodes[i]);
+              }
+            });
+          }
+          for (std::thread & thread : threads){
+            thread.join();
+          }
+          // The tables only hold the shared parts of the released nodes
+          clear();
+        }
+        
+        /*!
+         \brief Accessor
+         \return true if edges are stored, false if only the passed nodes are kept
+         */
+        inline bool store_edges() const
+        {
+          return _store_edges;
         }
         
         inline bool check_edge_exist(node_ptr_t const & src, node_ptr_t const & tgt,
@@ -98,13 +497,16 @@ namespace tchecker_ext{
         \param tgt : target node counter will be modified
         \param edge_type : type of edge
         \param check_existence: whether to always insert or not
-        \post an edge src -> tgt with type edge_type has been allocated and added to the graph
+        \param worker : worker adding the edge
+        \post an edge src -> tgt with type edge_type has been allocated from the edge arena of worker (from
+        the edge allocator of the graph if there are no edge arenas) and added to the graph
         \note reference counter of newly created edge will be changed
         \note if check_existence is true, an edge will only be created of no other edge already exists
         \note if an abstract edge exists between src and target it will be "promoted"
         */
       void add_edge_swap(node_ptr_t const & src, node_ptr_t const & tgt,
-                         enum tchecker::covreach::edge_type_t edge_type, bool check_existence=true)
+                         enum tchecker::covreach::edge_type_t edge_type, bool check_existence=true,
+                         unsigned int worker=0)
       {
         // TODO make this more beautiful
         // TODO make timing an option
@@ -115,7 +517,9 @@ namespace tchecker_ext{
         }
         // No such edge could be found
         // -> Allocate and place
-        edge_ptr_t edge = cov_graph_t::_edge_allocator.construct(edge_type);
+        edge_allocator_t & edge_allocator =
+            (worker < _n_edge_arenas ? *_edge_arenas[worker].value : cov_graph_t::_edge_allocator);
+        edge_ptr_t edge = edge_allocator.construct(edge_type);
         dir_graph_t::add_edge_swap(src, tgt, edge);
       }
       
@@ -217,9 +621,9 @@ namespace tchecker_ext{
       }
       
       /*!
-       * \brief Delete all elements which are still local
+       * \brief Delete all successors, which are still local
        * \note This is an optimization for the following case:
-       * The successors of a state have been computed and partially inserted into the graph. Now another thread
+       * The successors of a state have been computed but not yet inserted into the graph. Now another thread
        * found a node covering the current parent node. In this case it is sure that for all successors of the
        * parent node a covering node which is a successor of the node covering the parent node does exist.
        * @tparam WORK_ELEM
@@ -228,48 +632,21 @@ namespace tchecker_ext{
        template <class WORK_ELEM>
        void delete_return(WORK_ELEM &work_elem){
          std::vector<node_ptr_t> &next_nodes_vec = work_elem.next_nodes_vec;
-         std::vector<tchecker::graph::cover::node_position_t> &associated_container_num =
-            work_elem.associated_container_num;
-         std::vector<bool> &is_treated = work_elem.is_treated;
         
-         bool all_null;
-        
-         // Delete locale node
          // Simply replace by null_ptr, no other thread can depend on them
          for (size_t i=0; i<next_nodes_vec.size(); ++i){
-           if (!is_treated[i] && (next_nodes_vec[i].ptr() != nullptr)){
-             // Local active node -> delete
-             next_nodes_vec[i] = node_ptr_t{nullptr};
-           }
+           assert((next_nodes_vec[i].ptr() == nullptr) || (next_nodes_vec[i]->refcount() == 1));
+           next_nodes_vec[i] = node_ptr_t{nullptr};
          }
-         // Delete already inserted nodes
-         while(true) {
-           all_null = true;
-           for (size_t i = 0; i < next_nodes_vec.size(); ++i) {
-             if (next_nodes_vec[i].ptr() != nullptr){
-               // Found one to delete
-               all_null = false;
-               // Lock the container
-               if (_container_locks[associated_container_num[i]].lock_once()){
-                 // TODO compare different possibilities
-                 // We erase it from next_nodes, so that no successors will be computed.
-                 // We leave the node in the cover graph so that no even small nodes will be expanded
-                 next_nodes_vec[i] = node_ptr_t{nullptr};
-                 // Done and unlock
-                 _container_locks[associated_container_num[i]].unlock();
-               }// if lock
-             }// if != null
-           }// for
-           if (all_null){
-             return;
-           }
-         }// while
        }
       
       /*!
        \brief "Main" function: Expands nodes via the given function and inserts the children into the graph
        \note Conceptually this is not very beautiful, as the expand function is passed as well.
        However this is necessary to avoid unnecessary expanding of nodes.
+       \note Locking protocol: the stripes of the parent and of all the active successors are acquired
+       together in increasing order (see tchecker_ext::lock_stripes_t::lock_all). Every thread acquires its
+       locks in the same global order, hence no deadlock and no livelock can occur
        @tparam STATS
        @param parent_node : Node to be expanded
        @param build_exp_node : function that computes the children
@@ -280,10 +657,6 @@ namespace tchecker_ext{
       template <class STATS, class WORK_ELEM>
       void build_and_insert(node_ptr_t &parent_node,
           std::function<void(node_ptr_t const &)> &build_exp_node, WORK_ELEM &work_elem, STATS &stats){
-        // The idea is to lock the parent container and
-        // then loop over the different containers and take one that is currently free
-        // Attention outer loop is necessary to ensure liveness
-        size_t no_access_counter=0, no_access=0, num_to_treat=0;
         node_ptr_t covering_node{nullptr}, next_node{nullptr};
         
         std::vector<node_ptr_t> &next_nodes_vec = work_elem.next_nodes_vec;
@@ -292,9 +665,11 @@ namespace tchecker_ext{
         std::vector<tchecker::graph::cover::node_position_t> &associated_container_num =
             work_elem.associated_container_num;
         std::vector<bool> &is_treated = work_elem.is_treated;
+        std::vector<std::size_t> &locked_stripes = work_elem.locked_stripes;
   
+        // Containers are locked through the stripe protecting them
         tchecker::graph::cover::node_position_t parent_container_num =
-            tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(parent_node);
+            _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(parent_node));
         
         // Before starting check if the parent is still active
         // This is "necessary" as we can no longer use waiting_ok
@@ -304,7 +679,7 @@ namespace tchecker_ext{
           // Delete the reference to the (inactive) parent
           // This is important as the reference counter of a node can only be safely changed
           // if the corresponding container is locked
-          parent_node = node_ptr_t{nullptr};
+          release(parent_container_num, parent_node);
           // Unlock and return
           _container_locks[parent_container_num].unlock();
           return;
@@ -325,14 +700,18 @@ namespace tchecker_ext{
         }
         
         // next_nodes are still thread local
-        // Loop once to get all container id's and count how many are active
+        // Loop once to get all stripes that have to be locked
+        locked_stripes.clear();
+        locked_stripes.push_back(parent_container_num);
         for (size_t i=0; i < next_nodes_vec.size(); ++i){
           assert(next_nodes_vec[i]->refcount()==1);
           if (next_nodes_vec[i]->is_active()){
-            num_to_treat++;
             is_treated[i] = false; // This node has to be handled
-            associated_container_num[i] =
-                tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(next_nodes_vec[i]);
+            if constexpr (LOCK::concurrent) {
+              associated_container_num[i] =
+                  _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(next_nodes_vec[i]));
+              locked_stripes.push_back(associated_container_num[i]);
+            }
           }else{
             // If they are inactive delete the reference
             next_nodes_vec[i] = node_ptr_t{nullptr};
@@ -340,117 +719,223 @@ namespace tchecker_ext{
           }
         }
         
-        // Loop invariant:
-        // The elements in next_nodes_vec are either
-        // is_treated[i] == false, next_nodes_vec[i] != null : Remains to be treated
-        // is_treated[i] == true, next_nodes_vec[i] != null : Node inserted in graph, to be inserted into waiting
-        // is_treated[i] == true, next_nodes_vec[i] == null : Directly covered
-        while (num_to_treat>0){ // Until all next_nodes_vec are treated; Outer loop to avoid dead-locks
-          // Lock the parent; This can produce a deadlock
-          // if all children and parents have the same states across all threads
-          _container_locks[parent_container_num].lock();
+        // Acquire the parent and all successor stripes in global order
+        if constexpr (LOCK::concurrent) {
+          _container_locks.lock_all(locked_stripes);
+        }
+        
+        // Without concurrency nobody can have covered the parent in the meantime
+        if(LOCK::concurrent && !parent_node->is_active()){
+          // The parent node became inactive since building the successors
+          // Therefore all child nodes will be covered at some point later on
+          // No need to insert them into waiting
+          // Release parent
+          release(parent_container_num, parent_node);
+          _container_locks.unlock_all(locked_stripes);
+          // Delete all in next_nodes, none of them has been inserted
+          return delete_return(work_elem);
+        }
+        
+        // After the loop the elements in next_nodes_vec are either
+        // next_nodes_vec[i] != null : Node inserted in graph, to be inserted into waiting
+        // next_nodes_vec[i] == null : (Directly) covered
+        for (size_t i=0; i < next_nodes_vec.size(); ++i) {
+          if (is_treated[i]){
+            continue; // Directly covered
+          }
+          assert(next_nodes_vec[i].ptr()!=nullptr);
           
-          assert(covered_nodes_vec.empty());
-          no_access_counter = 0;
-          while (num_to_treat>0){ // Until all next_nodes_vec are treated
-            
-            if(!parent_node->is_active()){
-              // The parent node became inactive since building the successors
-              // Therefore all child nodes will be covered at some point later on
-              // No need to insert them into waiting
-              // Release parent
-              parent_node = node_ptr_t{nullptr};
-              _container_locks[parent_container_num].unlock();
-              // (Safely) Delete all in next_nodes
-              return delete_return(work_elem);
+          //Swap them so that next_nodes_vec[i] becomes nullptr
+          next_node.swap(next_nodes_vec[i]);
+          is_treated[i] = true;
+          
+          // Now we can treat the next_node as all the nodes that we have to compare it to are stored in this (locked) container
+          if (tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::is_covered_external(next_node, covering_node)){ //covered?
+            // This is ok as parent and covering are locked
+            // Here one can or cannot search for existing edges
+            // TODO make this an option
+            if (_store_edges){
+              add_edge_swap(parent_node, covering_node, tchecker::covreach::ABSTRACT_EDGE, true, work_elem.worker);
             }
-            
-            no_access = 1; // No child container has been accessed
-            for (size_t i=0; i < next_nodes_vec.size(); ++i) { // Loop over next_nodes_vec to check which one we can treat next
-              if (is_treated[i]){
-                continue; // Already done
+            if (_evictor){
+              _evictor->hit(_container_locks.stripe(
+                  tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(covering_node)), covering_node);
+            }
+            // Safely delete the next_node/covering_node reference
+            next_node = node_ptr_t{nullptr};
+            covering_node = node_ptr_t{nullptr};
+            stats.increment_covered_leaf_nodes();
+          }else if (_federations &&
+                    _federations->covered(_container_locks.stripe(
+                                              tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(next_node)),
+                                          discrete_key(next_node), next_node,
+                                          work_elem.union_zones, work_elem.union_pieces, work_elem.union_next)){
+            // Covered by the union of the zones of stored nodes, no edge is stored
+            next_node = node_ptr_t{nullptr};
+            stats.increment_covered_leaf_nodes();
+          }else{ // covering?
+            // Now we are sure that the node is not included in some other node
+            // and we will add it to the graph along with the edge
+            assert(next_node->is_active());
+            // Merge and share the discrete part and the zone while next_node is still local, its stripe is locked
+            if (_intern_discrete || _intern_zones || _evictor || _merger || _federations){
+              std::size_t const stripe =
+                  _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(next_node));
+              if (_merger){
+                // Merged nodes are included in next_node, they are covered below
+                std::size_t const key = discrete_key(next_node);
+                _merger->merge(stripe, key, next_node, work_elem.merge_hull, work_elem.merge_scratch);
+                _merger->inserted(stripe, key, next_node);
               }
-              assert(next_nodes_vec[i].ptr()!=nullptr);
-              // Check if the associated container is free AND acquire it
-              // Except if it is the same container as parent, then ok...
-              if (_container_locks[associated_container_num[i]].lock_once()
-                  || (associated_container_num[i]==parent_container_num) ){
-                
-                no_access = 0; // Got access to at least one
-                
-                //Swap them so that next_nodes_vec[i] becomes nullptr
-                next_node.swap(next_nodes_vec[i]);
-
-                // Mark as treated
-                --num_to_treat;
-                is_treated[i] = true;
-                
-                // Now we can treat the next_node as all the nodes that we have to compare it to are stored in this (now locked) container
-                if (tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::is_covered_external(next_node, covering_node)){ //covered?
-                  // This is ok as parent and covering are locked
-                  // Here one can or cannot search for existing edges
-                  // TODO make this an option
-                  add_edge_swap(parent_node, covering_node, tchecker::covreach::ABSTRACT_EDGE, true);
-                  // Safely delete the next_node/covering_node reference
-                  next_node = node_ptr_t{nullptr};
-                  covering_node = node_ptr_t{nullptr};
-                  stats.increment_covered_leaf_nodes();
-                }else{ // covering?
-                  // Now we are sure that the node is not included in some other node
-                  // and we will add it to the graph along with the edge
-                  assert(next_node->is_active());
-                  //From now on others threads can possible see it if the corresponding container is unlocked
-                  tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::add_node(next_node);
-                  // ok parent and next_node is locked
-                  // Here it is sure that no other edge exists -> do not check
-                  add_edge_swap(parent_node, next_node, tchecker::covreach::ACTUAL_EDGE, false);
-                  
-                  // Check if this new node covers others
-                  assert(covered_nodes_vec.empty());
-                  //next_node and covered nodes are in the same container so we can change the reference counter
-                  cov_graph_t::covered_nodes(next_node, covered_nodes_vec_inserter);
-
-                  for (size_t j=0; j<covered_nodes_vec.size(); ++j ){
-                    covered_nodes_vec[j]->make_inactive();
-                    cover_node(covered_nodes_vec[j], next_node);
-                    stats.increment_covered_nonleaf_nodes();
-                  }// covered
-                  covered_nodes_vec.clear(); //Clear before releasing the container
-                  // Swap it back into the vector as this node remains active
-                  next_node.swap(next_nodes_vec[i]);
-                }//covering
-                
-                //Make sure all ptr as reset before releasing the container
-                assert(covered_nodes_vec.empty());
-                assert(next_node.ptr() == nullptr);
-                assert(covering_node.ptr() == nullptr);
-                
-                // Finished treating this node
-                // Unlock, except if parent
-                if(associated_container_num[i]!=parent_container_num){
-                  _container_locks[associated_container_num[i]].unlock(); // Release container
-                }
-              } // if locked
-            } // for next_node : next_nodes_vec
-            no_access_counter += no_access;
-            
-            if (no_access_counter>100){//todo parametrize or find the right time/nbr of cycles
-              _container_locks[parent_container_num].unlock();//Release container
-              // Give other threads a chance
-              std::this_thread::sleep_for(std::chrono::microseconds(5));
-              break;
+              if (_federations){
+                _federations->inserted(stripe, discrete_key(next_node), next_node);
+              }
+              if (_evictor){
+                _evictor->inserted(stripe, next_node);
+              }
+              if (_intern_discrete){
+                _discrete_table.intern(stripe, next_node);
+              }
+              if (_intern_zones){
+                _zone_table.intern(next_node);
+              }
+            }
+            //From now on others threads can possible see it once the corresponding container is unlocked
+            tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::add_node(next_node);
+            _inserted_nodes.fetch_add(1, std::memory_order_relaxed);
+            if (_node_bytes.load(std::memory_order_relaxed) == 0){
+              std::size_t const dim = next_node->zone().dim();
+              _node_bytes.store(sizeof(*next_node) + dim * dim * sizeof(tchecker::dbm::db_t), std::memory_order_relaxed);
             }
-          } // while untreated
-        } // while untreated deadlocks
+            // ok parent and next_node is locked
+            // Here it is sure that no other edge exists -> do not check
+            if (_store_edges){
+              add_edge_swap(parent_node, next_node, tchecker::covreach::ACTUAL_EDGE, false, work_elem.worker);
+            }
+            
+            // Check if this new node covers others
+            assert(covered_nodes_vec.empty());
+            //next_node and covered nodes are in the same container so we can change the reference counter
+            cov_graph_t::covered_nodes(next_node, covered_nodes_vec_inserter);
+
+            for (size_t j=0; j<covered_nodes_vec.size(); ++j ){
+              covered_nodes_vec[j]->make_inactive();
+              cover_node(covered_nodes_vec[j], next_node);
+              stats.increment_covered_nonleaf_nodes();
+              // The stripe of next_node and covered node is locked
+              release(_container_locks.stripe(
+                  tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(covered_nodes_vec[j])),
+                      covered_nodes_vec[j]);
+            }// covered
+            covered_nodes_vec.clear(); //Clear before releasing the container
+            // Swap it back into the vector as this node remains active
+            next_node.swap(next_nodes_vec[i]);
+          }//covering
+          
+          //Make sure all ptr as reset before releasing the containers
+          assert(covered_nodes_vec.empty());
+          assert(next_node.ptr() == nullptr);
+          assert(covering_node.ptr() == nullptr);
+        } // for next_node : next_nodes_vec
   
+        // The parent has been expanded: it is a passed node, only its zone constraints are needed to
+        // decide covering
+        if (_evictor && parent_node->is_active()){
+          _evictor->passed(parent_container_num, parent_node);
+        }
+        if (_compress_expanded && parent_node->is_active()){
+          compress_zone(parent_container_num, parent_node);
+        }
+        
         // Also safely release the reference to the parent
-        parent_node = node_ptr_t{nullptr};
-        //Release parent container
-        _container_locks[parent_container_num].unlock();
+        release(parent_container_num, parent_node);
+        //Release all containers
+        if constexpr (LOCK::concurrent) {
+          _container_locks.unlock_all(locked_stripes);
+        }
 
         return;
       }//check_and_insert
       
+      /*!
+       \brief Release a reference to a stored node
+       \param node : a stored node
+       \post node is nullptr, the reference has been released under the lock of the stripe of node, or without
+       locking if reference counters are atomic and no side table tracks the last reference to a node
+       \note thread safe
+       */
+      void release_node(node_ptr_t & node){
+        if constexpr (atomic_refcount) {
+          if (!tracks_last_reference()) {
+            node = node_ptr_t{nullptr};
+            return;
+          }
+        }
+        std::size_t const stripe =
+            _container_locks.stripe(tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::get_node_position(node));
+        _container_locks[stripe].lock();
+        release(stripe, node);
+        _container_locks[stripe].unlock();
+      }
+      
+      /*!
+       \brief Relieve memory pressure
+       \post if the memory limit is exceeded, and no other thread relieves memory pressure, the cold
+       passed nodes have been compressed or evicted (see tchecker_ext::covreach_ext::cold_node_evictor_t).
+       Evicted nodes have been removed from the graph, the references of the graph have been released
+       \pre the calling thread does not hold any lock of the graph
+       \note thread safe. Stripes are locked one at a time
+       */
+      void relieve_memory_pressure(){
+        if (!_evictor || !_evictor->begin_pass(live_bytes())){
+          return;
+        }
+        for (std::size_t stripe=0; stripe<_container_locks.size(); ++stripe){
+          _container_locks[stripe].lock();
+          _evictor->sweep(stripe,
+                          [&] (node_ptr_t const & n) {
+                            if (!_compressed_zones || _compressed_zones->is_compressed(n)){
+                              return false;
+                            }
+                            compress_zone(stripe, n);
+                            return true;
+                          },
+                          [&] (node_ptr_t & n) {
+                            n->make_inactive();
+                            tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::remove_node(n);
+                            _dead_nodes.fetch_add(1, std::memory_order_relaxed);
+                            release(stripe, n);
+                          });
+          _container_locks[stripe].unlock();
+        }
+        _evictor->end_pass(live_bytes());
+      }
+      
+      /*!
+       \brief Accessor
+       \return estimate of the memory used by the stored nodes (bytes): nodes with dense zones, records of
+       the compressed zones, and tables of the evictor
+       \note thread safe. Only the memory that the graph frees when it removes or compresses nodes is
+       counted, unlike the resident memory of the process. Shared zones are counted once per node
+       \note not counted: the tuples of locations and integer valuations of the nodes, the edges and the
+       buckets of the graph, the waiting lists, the tables of interning, merging and federations, and the
+       free slots of the pools. The memory limit (see cold_node_evictor_t) bounds this estimate only
+       */
+      std::size_t live_bytes() const
+      {
+        std::size_t const inserted = _compacted_nodes + _inserted_nodes.load(std::memory_order_relaxed);
+        std::size_t const dead = _dead_nodes.load(std::memory_order_relaxed);
+        std::size_t bytes = (inserted > dead ? inserted - dead : 0) * _node_bytes.load(std::memory_order_relaxed);
+        if (_compressed_zones){
+          std::size_t const released = _compressed_zones->dbm_bytes();
+          bytes = (bytes > released ? bytes - released : 0) + _compressed_zones->arena_bytes();
+        }
+        if (_evictor){
+          bytes += _evictor->bookkeeping_bytes();
+        }
+        return bytes;
+      }
+      
       /*!
        \brief Cover a node
        \param covered_node : covered node
@@ -461,16 +946,52 @@ namespace tchecker_ext{
        */
       void cover_node(node_ptr_t & covered_node, node_ptr_t & covering_node)
       {
-        // This is ok, as covered_node and covering_node are locked
-        move_incoming_edges(covered_node, covering_node, true, tchecker::covreach::ABSTRACT_EDGE);
-        // The successors of covering_node can cover any successor of covered_node
-        // currently, if the successor of covering node is exactly as large as some child of covered_node,
-        // there will only be an abstract_edge between them though it should be actual
-        move_outgoing_edges(covered_node, covering_node);
+        if (_store_edges){
+          // This is ok, as covered_node and covering_node are locked
+          move_incoming_edges(covered_node, covering_node, true, tchecker::covreach::ABSTRACT_EDGE);
+          // The successors of covering_node can cover any successor of covered_node
+          // currently, if the successor of covering node is exactly as large as some child of covered_node,
+          // there will only be an abstract_edge between them though it should be actual
+          move_outgoing_edges(covered_node, covering_node);
+        }
         tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::remove_node(covered_node);
+        _dead_nodes.fetch_add(1, std::memory_order_relaxed);
         return;
       }
       
+      /*!
+       \brief Freeze the graph into a compact post-run snapshot
+       \param num_threads : number of threads used to build the snapshot
+       \return a compressed sparse row snapshot of this graph with dense node ids
+       \pre no other thread modifies the graph
+       \throw std::overflow_error : if the graph has too many nodes for 32 bits ids (see
+       csr_graph_t::max_nodes)
+       \note the snapshot holds a reference to every node, it has to be cleared before
+       the allocators of this graph are freed. The graph can be cleared first: the nodes stay alive in the
+       snapshot, without the edges and buckets of the graph
+       \note dense 32 bits node ids only exist in the snapshot, the graph itself refers to nodes by pointers.
+       The snapshot is what the graph is output from once the algorithm is over
+       */
+      tchecker_ext::covreach_ext::csr_graph_t<node_ptr_t> freeze(unsigned int num_threads)
+      {
+        std::vector<node_ptr_t> nodes;
+        get_all_nodes(nodes);
+        
+        tchecker_ext::covreach_ext::csr_graph_t<node_ptr_t> frozen;
+        // Walks the outgoing list without taking references
+        frozen.build(std::move(nodes),
+                     [this](node_ptr_t const & n, auto && f){
+                       const edge_ptr_t end_ptr = edge_ptr_t{nullptr};
+                       edge_ptr_t * current_edge_ptr = &dir_graph_t::get_outgoing_head(n);
+                       while (*current_edge_ptr != end_ptr){
+                         f(dir_graph_t::edge_tgt(*current_edge_ptr), (*current_edge_ptr)->edge_type());
+                         current_edge_ptr = &dir_graph_t::get_next_outgoing_edge(*current_edge_ptr);
+                       }
+                     },
+                     num_threads);
+        return frozen;
+      }
+      
       /*!
        * \brief Helper function to print total edge checking time
        */
@@ -479,8 +1000,168 @@ namespace tchecker_ext{
       }
 
     protected:
+      /*!
+       \brief Hash value of a discrete part
+       \param node : a node
+       \return hash value of the tuple of locations and the integer valuation of node, from their packed
+       encoding stored in node if discrete parts are packed
+       \pre see tchecker_ext::covreach_ext::node_t::pack()
+       */
+      inline std::size_t discrete_key(node_ptr_t const & node) const
+      {
+        return (_packer ? node->pack(*_packer).hash() : tchecker::ta::details::hash_value(*node));
+      }
+      
+      /*!
+       \brief Accessor
+       \return true if releasing the last reference to a node has to update a side table (see release()),
+       false otherwise
+       */
+      inline bool tracks_last_reference() const
+      {
+        return (_compressed_zones || _evictor || _merger || _federations || _intern_discrete || _intern_zones);
+      }
+      
+      /*!
+       \brief Release a reference to a node
+       \param stripe : stripe of node
+       \param node : a node
+       \pre stripe is locked by the caller (or no other thread accesses the graph)
+       \post node is nullptr. If it was the last reference, the shared parts of the node have been released
+       here, not in the garbage collector, and the node has been erased from the compressed zones, the
+       passed nodes and the merging candidates
+       */
+      void release(std::size_t stripe, node_ptr_t & node)
+      {
+        if (node->refcount() == 1){
+          if (_compressed_zones){
+            _compressed_zones->erase(stripe, node);
+          }
+          if (_evictor){
+            _evictor->erase(stripe, node);
+          }
+          if (_merger){
+            _merger->erase(stripe, discrete_key(node), node);
+          }
+          if (_federations){
+            _federations->erase(stripe, discrete_key(node), node);
+          }
+          if (_intern_discrete){
+            tchecker_ext::covreach_ext::discrete_intern_table_t<node_ptr_t>::detach(node);
+          }
+          if (_intern_zones && (node->zone_ptr().ptr() != nullptr)){
+            _zone_table.detach(node);
+          }
+        }
+        node = node_ptr_t{nullptr};
+      }
+      
+      /*!
+       \brief Compress the zone of a node
+       \param stripe : stripe of node
+       \param node : a node
+       \pre see tchecker_ext::covreach_ext::compressed_zone_store_t::compress()
+       \post the minimal constraints of the zone of node are stored in the compressed zones, node has released
+       its zone (through the table of canonical zones if zones are shared)
+       */
+      void compress_zone(std::size_t stripe, node_ptr_t const & node)
+      {
+        _compressed_zones->compress(stripe, node);
+        if (_intern_zones){
+          _zone_table.detach(node);
+        }
+        else {
+          node->zone_ptr() = zone_ptr_t{nullptr};
+        }
+      }
+      
+      /*!
+       \brief Relocate a node
+       \param stripe : stripe of node
+       \param node : a stored node
+       \param arena : index of a compaction arena
+       \pre no other thread accesses the graph. The caller holds one reference to node
+       \post if node is active, its zone is not compressed and it is only referenced by the graph and the
+       caller, a copy of node allocated from compaction arena arena replaces node in the graph (with its
+       edges, its shared parts and its packed discrete part), and node is only referenced by the caller. The copy is counted in the
+       nodes of arena
+       \return true if node has been relocated, false otherwise
+       */
+      bool relocate(std::size_t stripe, node_ptr_t const & node, unsigned int arena)
+      {
+        if (!node->is_active()){
+          return false;
+        }
+        if (_compressed_zones && _compressed_zones->is_compressed(node)){
+          return false;
+        }
+        // One reference from the bucket, one from the caller, one per edge
+        std::size_t references = 2;
+        if (_store_edges){
+          const edge_ptr_t end_ptr = edge_ptr_t{nullptr};
+          for (edge_ptr_t * e = &dir_graph_t::get_incoming_head(node); *e != end_ptr; e = &dir_graph_t::get_next_incoming_edge(*e)){
+            ++references;
+          }
+          for (edge_ptr_t * e = &dir_graph_t::get_outgoing_head(node); *e != end_ptr; e = &dir_graph_t::get_next_outgoing_edge(*e)){
+            ++references;
+          }
+        }
+        if (node->refcount() != references){
+          return false; // Waiting or root node
+        }
+        node_ptr_t moved = _compaction_arenas[arena]->construct_from_state(node);
+        _compaction_arena_nodes[arena].fetch_add(1, std::memory_order_relaxed);
+        moved->arena_nodes() = &_compaction_arena_nodes[arena];
+        moved->copy_packed_discrete(*node);
+        if (_intern_discrete){
+          _discrete_table.intern(stripe, moved, true);
+        }
+        if (_intern_zones){
+          _zone_table.intern(moved, true);
+        }
+        if (_evictor){
+          _evictor->relocated(stripe, node, moved);
+        }
+        if (_merger){
+          _merger->relocated(stripe, discrete_key(node), node, moved);
+        }
+        if (_federations){
+          _federations->relocated(stripe, discrete_key(node), node, moved);
+        }
+        if (_store_edges){
+          move_incoming_edges(node, moved);
+          move_outgoing_edges(node, moved);
+        }
+        tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::remove_node(node);
+        tchecker::covreach::graph_t<KEY, TS, TS_ALLOCATOR>::add_node(moved);
+        return true;
+      }
+      
       // TODO the locks should probably go to cover/graph for more coherence
-      std::vector<tchecker_ext::spinlock_t> _container_locks; /*! One lock for each node_ptr_t container */
+      tchecker_ext::lock_stripes_t<LOCK> _container_locks; /*! Cache-line padded locks, each protecting a stripe of node_ptr_t containers */
+      bool _store_edges; /*! Whether edges are stored or only the passed nodes */
+      bool _intern_discrete; /*! Whether stored nodes share equal discrete parts */
+      tchecker_ext::covreach_ext::discrete_intern_table_t<node_ptr_t> _discrete_table; /*! Canonical discrete parts, one table per stripe */
+      std::shared_ptr<tchecker_ext::covreach_ext::discrete_packer_t const> _packer; /*! Layout of packed discrete parts (or nullptr) */
+      bool _intern_zones; /*! Whether stored nodes share equal zones */
+      tchecker_ext::covreach_ext::zone_intern_table_t<node_ptr_t, LOCK> _zone_table; /*! Canonical zones of the graph, sharded by zone hash value */
+      std::shared_ptr<tchecker_ext::covreach_ext::compressed_zone_store_t<node_ptr_t>> _compressed_zones; /*! Compressed zones of passed nodes (or nullptr) */
+      bool _compress_expanded; /*! Whether zones are compressed as soon as nodes have been expanded */
+      std::shared_ptr<tchecker_ext::covreach_ext::cold_node_evictor_t<node_ptr_t>> _evictor; /*! Eviction of cold passed nodes (or nullptr) */
+      std::shared_ptr<tchecker_ext::covreach_ext::zone_merger_t<node_ptr_t>> _merger; /*! Stored nodes by discrete part for zone merging (or nullptr) */
+      std::shared_ptr<tchecker_ext::covreach_ext::federation_store_t<node_ptr_t>> _federations; /*! Stored nodes by discrete part for covering by federations (or nullptr) */
+      double _compaction_threshold = 0.0; /*! Fraction of removed nodes above which a compaction is due (0: no compaction) */
+      std::atomic_size_t _compaction_arena_nodes[2] = {{0}, {0}}; /*! Number of nodes of each compaction arena not destructed yet */
+      std::unique_ptr<state_allocator_t> _compaction_arenas[2]; /*! Node arenas used in turn by compactions */
+      tchecker::gc_t * _gc = nullptr; /*! Garbage collector of the compaction arenas */
+      unsigned int _n_edge_arenas = 0; /*! Number of per-worker edge arenas (0: edges come from the graph's allocator) */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<std::unique_ptr<edge_allocator_t>>[]> _edge_arenas; /*! Edge arena of each worker */
+      std::size_t _n_compactions = 0; /*! Number of compactions */
+      std::size_t _relocated_nodes = 0; /*! Number of nodes relocated by compactions */
+      std::size_t _compacted_nodes = 0; /*! Number of stored nodes at the last compaction */
+      std::atomic_size_t _inserted_nodes{0}; /*! Number of nodes inserted since the last compaction */
+      std::atomic_size_t _dead_nodes{0}; /*! Number of nodes removed since the last compaction */
+      std::atomic_size_t _node_bytes{0}; /*! Size of a node and of its dense zone (0 until a node is stored) */
       // Timing // todo make optional
       std::atomic_size_t _tot_edge_check_time;
     };
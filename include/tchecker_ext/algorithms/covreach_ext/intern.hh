@@ -0,0 +1,633 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_INTERN_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_INTERN_HH
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tchecker/algorithms/covreach/cover.hh"
+#include "tchecker/clockbounds/clockbounds.hh"
+#include "tchecker/dbm/dbm.hh"
+#include "tchecker/ta/details/state.hh"
+
+#include "tchecker_ext/algorithms/covreach_ext/compressed_zones.hh"
+#include "tchecker_ext/algorithms/covreach_ext/packed_discrete.hh"
+#include "tchecker_ext/dbm/simd.hh"
+#include "tchecker_ext/utils/lock_stripes.hh"
+
+/*!
+ \file intern.hh
+ \brief Hash-consing of the discrete part (tuple of locations and valuation of integer variables) and of
+ the zone of nodes
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class discrete_intern_table_t
+     \brief Tables of canonical discrete parts, one table per stripe of the nodes table
+     \tparam NODE_PTR : type of pointer to node
+     \note A node stored in the graph can share the tuple of locations and the integer valuation of
+     an equal node instead of keeping its own copy. The reference counters of these shared objects are
+     not atomic. Hence, a canonical object is only ever shared by nodes of a single stripe, and its
+     counter is only modified under the lock of this stripe:
+     - intern() is called on insertion of a node in the graph, under the lock of its stripe
+     - detach() is called on release of the last reference to a node, under the lock of its stripe,
+     so that the garbage collector never decrements the counter of a shared object
+     Nodes with equal discrete parts have the same key, hence they are in the same stripe and share
+     as much as possible
+     \note with a packer (see set_packer()), canonical parts are found by their packed encoding: one
+     lookup that hashes and compares two words instead of the tuples and valuations. The encoding is the
+     one stored in the node (see tchecker_ext::covreach_ext::node_t::pack())
+     */
+    template <class NODE_PTR>
+    class discrete_intern_table_t {
+    public:
+      /*!
+       \brief Type of nodes
+       */
+      using node_t = std::remove_reference_t<decltype(*std::declval<NODE_PTR const &>())>;
+
+      /*!
+       \brief Type of shared pointer to tuple of locations
+       */
+      using vloc_ptr_t = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<node_t &>().vloc_ptr())>>;
+
+      /*!
+       \brief Type of shared pointer to valuation of integer variables
+       */
+      using intvars_val_ptr_t =
+          std::remove_cv_t<std::remove_reference_t<decltype(std::declval<node_t &>().intvars_valuation_ptr())>>;
+
+      /*!
+       \brief Constructor
+       \param n_stripes : number of stripes of the nodes table
+       \post this has n_stripes empty tables
+       */
+      explicit discrete_intern_table_t(std::size_t n_stripes=1)
+      : _n_stripes(n_stripes),
+        _packer(nullptr),
+        _tables(new tchecker_ext::cache_aligned_t<stripe_table_t>[n_stripes])
+      {
+        assert(n_stripes > 0);
+      }
+
+      discrete_intern_table_t(tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> const &) = delete;
+      discrete_intern_table_t(tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> &&) = default;
+      ~discrete_intern_table_t() = default;
+      tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> const &) = delete;
+      tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::discrete_intern_table_t<NODE_PTR> &&) = default;
+
+      /*!
+       \brief Set packer
+       \param packer : layout of packed discrete parts, nullptr to compare discrete parts as they are
+       \pre this is empty, packer is enabled or nullptr, packer outlives this
+       \post canonical discrete parts are found from their packed encoding by packer
+       */
+      void set_packer(tchecker_ext::covreach_ext::discrete_packer_t const * packer)
+      {
+        assert((packer == nullptr) || packer->enabled());
+        _packer = packer;
+      }
+
+      /*!
+       \brief Share the discrete part of a node
+       \param stripe : stripe of node
+       \param node : a node
+       \param relocated : whether node is a copy of a stored node that it replaces (see compaction)
+       \pre stripe is locked by the caller, node is stored in stripe (or about to be)
+       \post node points to the canonical tuple of locations and integer valuation of stripe equal to its
+       own. If there was none, the ones of node have become canonical. Unless relocated, sharing is counted
+       \return true if node now shares its discrete part, false if it became canonical
+       */
+      bool intern(std::size_t stripe, NODE_PTR const & node, bool relocated=false)
+      {
+        assert(stripe < _n_stripes);
+        stripe_table_t & table = _tables[stripe].value;
+        if (_packer != nullptr) {
+          auto [it, inserted] = table.packed.try_emplace(node->pack(*_packer), node->vloc_ptr(),
+                                                         node->intvars_valuation_ptr());
+          if (inserted)
+            return false;
+          node->vloc_ptr() = it->second.first;
+          node->intvars_valuation_ptr() = it->second.second;
+          if (!relocated)
+            ++table.shared;
+          return true;
+        }
+        std::vector<entry_t> & entries = table.entries[tchecker::ta::details::hash_value(*node)];
+        for (entry_t & e : entries) {
+          // Pointer comparison first: the parts may already be shared
+          if (((e.first == node->vloc_ptr()) || (*e.first == node->vloc())) &&
+              ((e.second == node->intvars_valuation_ptr()) || (*e.second == node->intvars_valuation()))) {
+            node->vloc_ptr() = e.first;
+            node->intvars_valuation_ptr() = e.second;
+            if (!relocated)
+              ++table.shared;
+            return true;
+          }
+        }
+        entries.emplace_back(node->vloc_ptr(), node->intvars_valuation_ptr());
+        return false;
+      }
+
+      /*!
+       \brief Release the discrete part of a node
+       \param node : a node
+       \pre node is the only reference to its node, the stripe of node is locked by the caller
+       \post node does not reference its tuple of locations and integer valuation anymore. The node
+       itself can only be destructed.
+       */
+      static void detach(NODE_PTR const & node)
+      {
+        assert(node->refcount() == 1);
+        node->vloc_ptr() = vloc_ptr_t{nullptr};
+        node->intvars_valuation_ptr() = intvars_val_ptr_t{nullptr};
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this, the garbage collector is stopped
+       \post all tables are empty, references to the canonical objects have been released
+       */
+      void clear()
+      {
+        for (std::size_t s = 0; s < _n_stripes; ++s) {
+          _tables[s].value.entries.clear();
+          _tables[s].value.packed.clear();
+          _tables[s].value.shared = 0;
+        }
+      }
+
+      /*!
+       \brief Accessor
+       \return number of canonical discrete parts
+       \pre no other thread modifies this
+       */
+      std::size_t canonical_count() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _n_stripes; ++s) {
+          n += _tables[s].value.packed.size();
+          for (auto const & [h, entries] : _tables[s].value.entries)
+            n += entries.size();
+        }
+        return n;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of nodes that have been made to share a canonical discrete part
+       \pre no other thread modifies this
+       */
+      std::size_t shared_count() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          n += _tables[s].value.shared;
+        return n;
+      }
+
+    private:
+      /*!
+       \brief Type of canonical discrete parts
+       */
+      using entry_t = std::pair<vloc_ptr_t, intvars_val_ptr_t>;
+
+      /*!
+       \class stripe_table_t
+       \brief Canonical discrete parts of the nodes of one stripe
+       */
+      struct stripe_table_t {
+        std::unordered_map<std::size_t, std::vector<entry_t>> entries; /*!< Canonical parts by hash value */
+        std::unordered_map<tchecker_ext::covreach_ext::packed_discrete_t, entry_t,
+                           tchecker_ext::covreach_ext::packed_discrete_hash_t> packed; /*!< Canonical parts by packed encoding */
+        std::size_t shared = 0; /*!< Number of interned nodes that share an existing canonical part */
+      };
+
+      std::size_t _n_stripes; /*!< Number of stripes */
+      tchecker_ext::covreach_ext::discrete_packer_t const * _packer; /*!< Layout of packed discrete parts (or nullptr) */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<stripe_table_t>[]> _tables; /*!< One table per stripe */
+    };
+
+
+    /*!
+     \class zone_intern_table_t
+     \brief Graph-wide table of canonical zones, sharded by zone hash value
+     \tparam NODE_PTR : type of pointer to node
+     \tparam LOCK : type of the locks of the shards
+     \note Identical zones often appear under different discrete parts, hence in different stripes of the
+     nodes table. A node stored in the graph can share the zone of any stored node. The table is split into
+     shards by hash value of the zones, each shard has its own lock. The reference counters of the canonical
+     zones are not atomic: they are only modified under the lock of the shard of the zone.
+     - intern() is called on insertion of a node in the graph
+     - detach() is called on release of the last reference to a node, or when its zone is compressed, so
+     that the garbage collector never decrements the counter of a shared zone
+     The table holds one reference to each canonical zone. The entry of a zone is released as soon as no
+     node references the zone anymore
+     \note the lock of a shard is never held while another lock is acquired
+     */
+    template <class NODE_PTR, class LOCK>
+    class zone_intern_table_t {
+    public:
+      /*!
+       \brief Type of nodes
+       */
+      using node_t = std::remove_reference_t<decltype(*std::declval<NODE_PTR const &>())>;
+
+      /*!
+       \brief Type of shared pointer to zone
+       */
+      using zone_ptr_t = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<node_t &>().zone_ptr())>>;
+
+      /*!
+       \brief Constructor
+       \param n_shards : number of shards
+       \post this has n_shards empty shards
+       */
+      explicit zone_intern_table_t(std::size_t n_shards=1)
+      : _locks(n_shards),
+        _shards(new tchecker_ext::cache_aligned_t<shard_t>[n_shards])
+      {}
+
+      zone_intern_table_t(tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> const &) = delete;
+      zone_intern_table_t(tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> &&) = default;
+      ~zone_intern_table_t() = default;
+      tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> &
+      operator= (tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> const &) = delete;
+      tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> &
+      operator= (tchecker_ext::covreach_ext::zone_intern_table_t<NODE_PTR, LOCK> &&) = default;
+
+      /*!
+       \brief Share the zone of a node
+       \param node : a node
+       \param relocated : whether node is a copy of a stored node that it replaces (see compaction)
+       \pre node is not referenced by another thread (its stripe is locked by the caller). The zone of node
+       is canonical (tight), so equal zones have equal DBMs, and it is not shared yet
+       \post node points to the canonical zone equal to its own. If there was none, the zone of node has
+       become canonical. Unless relocated, sharing is counted
+       \return true if node now shares its zone, false if it became canonical
+       \note thread safe
+       */
+      bool intern(NODE_PTR const & node, bool relocated=false)
+      {
+        tchecker::clock_id_t const dim = node->zone().dim();
+        std::size_t const h = tchecker::dbm::hash(node->zone().dbm(), dim);
+        std::size_t const s = shard(h);
+        shard_t & sh = _shards[s].value;
+        _locks[s].lock();
+        std::vector<zone_ptr_t> & entries = sh.entries[h];
+        for (zone_ptr_t & z : entries) {
+          if (*z == node->zone()) {
+            node->zone_ptr() = z;
+            if (!relocated) {
+              ++sh.shared;
+              sh.saved_bytes += dim * dim * sizeof(tchecker::dbm::db_t);
+            }
+            _locks[s].unlock();
+            return true;
+          }
+        }
+        entries.emplace_back(node->zone_ptr());
+        _locks[s].unlock();
+        return false;
+      }
+
+      /*!
+       \brief Release the zone of a node
+       \param node : a node
+       \pre node is not referenced by another thread (its stripe is locked by the caller), its zone is not
+       nullptr
+       \post node does not reference its zone anymore. If the zone is canonical and no other node references
+       it, its entry has been removed from this
+       \note thread safe
+       */
+      void detach(NODE_PTR const & node)
+      {
+        std::size_t const h = tchecker::dbm::hash(node->zone().dbm(), node->zone().dim());
+        std::size_t const s = shard(h);
+        shard_t & sh = _shards[s].value;
+        _locks[s].lock();
+        node->zone_ptr() = zone_ptr_t{nullptr};
+        // Zones referenced by the table only are released
+        auto it = sh.entries.find(h);
+        if (it != sh.entries.end()) {
+          std::vector<zone_ptr_t> & entries = it->second;
+          std::size_t k = 0;
+          while (k < entries.size()) {
+            if (entries[k]->refcount() == 1) {
+              entries[k].swap(entries.back());
+              entries.pop_back();
+            }
+            else
+              ++k;
+          }
+          if (entries.empty())
+            sh.entries.erase(it);
+        }
+        _locks[s].unlock();
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this, the garbage collector is stopped
+       \post all shards are empty, references to the canonical zones have been released
+       */
+      void clear()
+      {
+        for (std::size_t s = 0; s < _locks.size(); ++s) {
+          _shards[s].value.entries.clear();
+          _shards[s].value.shared = 0;
+          _shards[s].value.saved_bytes = 0;
+        }
+      }
+
+      /*!
+       \brief Accessor
+       \return number of canonical zones
+       \pre no other thread modifies this
+       */
+      std::size_t canonical_count() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _locks.size(); ++s)
+          for (auto const & [h, entries] : _shards[s].value.entries)
+            n += entries.size();
+        return n;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of nodes that have been made to share a canonical zone
+       \pre no other thread modifies this
+       */
+      std::size_t shared_count() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _locks.size(); ++s)
+          n += _shards[s].value.shared;
+        return n;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of DBM bytes that did not have to be stored thanks to sharing
+       \pre no other thread modifies this
+       */
+      std::size_t saved_bytes() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _locks.size(); ++s)
+          n += _shards[s].value.saved_bytes;
+        return n;
+      }
+
+    private:
+      /*!
+       \brief Shard of a hash value
+       \param h : hash value of a zone
+       \return shard of the zones with hash value h
+       \note the low bits of h select the bucket in the shard, the shard is selected by the high bits
+       */
+      inline std::size_t shard(std::size_t h) const
+      {
+        return (h >> 32) % _locks.size();
+      }
+
+      /*!
+       \class shard_t
+       \brief Canonical zones of one shard
+       */
+      struct shard_t {
+        std::unordered_map<std::size_t, std::vector<zone_ptr_t>> entries; /*!< Canonical zones by hash value */
+        std::size_t shared = 0; /*!< Number of interned nodes that share an existing canonical zone */
+        std::size_t saved_bytes = 0; /*!< Size of the DBMs of these nodes */
+      };
+
+      tchecker_ext::lock_stripes_t<LOCK> _locks; /*!< One lock per shard */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<shard_t>[]> _shards; /*!< Shards */
+    };
+
+
+    /*!
+     \class interned_state_predicate_t
+     \brief Predicate on the discrete part of nodes that compares pointers before contents
+     \tparam STATE_PREDICATE : type of predicate deciding the equality of the discrete parts of two states
+     \note nodes sharing their discrete part (see discrete_intern_table_t) are equal by a pointer comparison.
+     Nodes with packed discrete parts (see tchecker_ext::covreach_ext::node_t::pack()) are compared by their
+     two words. Otherwise the contents are compared by STATE_PREDICATE
+     */
+    template <class STATE_PREDICATE>
+    class interned_state_predicate_t : public STATE_PREDICATE {
+    public:
+      using STATE_PREDICATE::STATE_PREDICATE;
+
+      /*!
+       \brief Predicate
+       \param s1 : state
+       \param s2 : state
+       \pre STATE is a tchecker_ext::covreach_ext::node_t, s1 and s2 are packed with the same packer if they
+       are both packed
+       \return true if the discrete parts of s1 and s2 are equal, false otherwise
+       */
+      template <class STATE>
+      bool operator() (STATE const & s1, STATE const & s2) const
+      {
+        if ((s1.vloc_ptr() == s2.vloc_ptr()) && (s1.intvars_valuation_ptr() == s2.intvars_valuation_ptr()))
+          return true;
+        if (s1.is_packed() && s2.is_packed())
+          return s1.packed_discrete() == s2.packed_discrete();
+        return STATE_PREDICATE::operator()(s1, s2);
+      }
+    };
+
+
+    /*!
+     \class interned_cover_node_t
+     \brief Covering predicate that decides nodes sharing their zone without comparing DBMs
+     \tparam COVER_NODE : type of covering predicate, built from arguments to a constructor of STATE_PREDICATE
+     and arguments to a constructor of its zone predicate. One of tchecker::covreach::cover_inclusion_t,
+     cover_alu_global_t, cover_alu_local_t, cover_am_global_t and cover_am_local_t
+     \tparam NODE_PTR : type of pointer to node
+     \tparam STATE_PREDICATE : type of predicate deciding the equality of the discrete parts of two states
+     \tparam MODEL : type of model, with the clock bounds maps of tchecker::clockbounds
+     \note a zone is included in itself: if two nodes share their zone (see zone_intern_table_t), only
+     their discrete parts are compared
+     \note zones of passed nodes may be compressed (see compressed_zone_store_t). Then inclusion is decided
+     on their constraints, hence COVER_NODE has to be zone inclusion
+     \note dense zones are compared by the vectorized kernels of tchecker_ext::dbm_ext: inclusion, aLU
+     inclusion with the bounds of the global or local LU map of the model, and aM inclusion with the bounds
+     of the global or local M map. Local bounds are those of the tuple of locations of the covered node (both
+     nodes have the same), computed into scratch maps of the calling thread
+     */
+    template <class COVER_NODE, class NODE_PTR, class STATE_PREDICATE, class MODEL>
+    class interned_cover_node_t : public COVER_NODE {
+    public:
+      /*!
+       \brief Constructor
+       \param model : a model
+       \param state_predicate_args : arguments to a constructor of STATE_PREDICATE
+       \param zone_predicate_args : arguments to a constructor of the zone predicate of COVER_NODE
+       \param compressed_zones : compressed zones of passed nodes, nullptr if zones are not compressed
+       \pre model outlives this
+       */
+      template <class ... STATE_PREDICATE_ARGS, class ... ZONE_PREDICATE_ARGS>
+      interned_cover_node_t(MODEL const & model,
+                            std::tuple<STATE_PREDICATE_ARGS...> && state_predicate_args,
+                            std::tuple<ZONE_PREDICATE_ARGS...> && zone_predicate_args,
+                            std::shared_ptr<tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR>> compressed_zones=nullptr)
+      : COVER_NODE(std::tuple<STATE_PREDICATE_ARGS...>(state_predicate_args),
+                   std::forward<std::tuple<ZONE_PREDICATE_ARGS...>>(zone_predicate_args)),
+        _model(model),
+        _state_predicate(std::make_from_tuple<STATE_PREDICATE>(state_predicate_args)),
+        _compressed_zones(compressed_zones)
+      {
+        if constexpr (is_alu_global) {
+          _l = &model.global_lu_map().L()[0];
+          _u = &model.global_lu_map().U()[0];
+        }
+        else if constexpr (is_am_global)
+          _m = &model.global_m_map().M()[0];
+      }
+
+      /*!
+       \brief Covering predicate
+       \param n1 : node
+       \param n2 : node
+       \return true if n1 is covered by n2, false otherwise
+       */
+      bool operator() (NODE_PTR const & n1, NODE_PTR const & n2)
+      {
+        // Compressed nodes have no zone, check them first
+        if (_compressed_zones &&
+            (_compressed_zones->is_compressed(n1) || _compressed_zones->is_compressed(n2)))
+          return _state_predicate(*n1, *n2) && _compressed_zones->is_le(n1, n2);
+        if (n1->zone_ptr() == n2->zone_ptr())
+          return _state_predicate(*n1, *n2);
+        if (!_state_predicate(*n1, *n2))
+          return false;
+        assert(n1->zone().dim() == n2->zone().dim());
+        tchecker::dbm::db_t const * dbm1 = n1->zone().dbm();
+        tchecker::dbm::db_t const * dbm2 = n2->zone().dbm();
+        tchecker::clock_id_t const dim = n1->zone().dim();
+        if constexpr (is_inclusion)
+          return tchecker_ext::dbm_ext::is_le(dbm1, dbm2, dim);
+        else if constexpr (is_alu_global)
+          return tchecker_ext::dbm_ext::is_alu_le(dbm1, dbm2, dim, _l, _u);
+        else if constexpr (is_alu_local) {
+          scratch_maps_t & scratch = this->scratch(_model.local_lu_map().clock_number());
+          _model.local_lu_map().bounds(n1->vloc(), *scratch.map1, *scratch.map2);
+          return tchecker_ext::dbm_ext::is_alu_le(dbm1, dbm2, dim, &(*scratch.map1)[0], &(*scratch.map2)[0]);
+        }
+        else if constexpr (is_am_global)
+          return tchecker_ext::dbm_ext::is_am_le(dbm1, dbm2, dim, _m);
+        else {
+          static_assert(is_am_local, "unsupported covering predicate");
+          scratch_maps_t & scratch = this->scratch(_model.local_m_map().clock_number());
+          _model.local_m_map().bounds(n1->vloc(), *scratch.map1);
+          return tchecker_ext::dbm_ext::is_am_le(dbm1, dbm2, dim, &(*scratch.map1)[0]);
+        }
+      }
+
+    private:
+      /*!
+       \brief Whether COVER_NODE is zone inclusion
+       */
+      static constexpr bool is_inclusion =
+          std::is_same<COVER_NODE, tchecker::covreach::cover_inclusion_t<NODE_PTR, STATE_PREDICATE>>::value;
+
+      /*!
+       \brief Whether COVER_NODE is aLU inclusion with global bounds
+       */
+      static constexpr bool is_alu_global =
+          std::is_same<COVER_NODE, tchecker::covreach::cover_alu_global_t<NODE_PTR, STATE_PREDICATE>>::value;
+
+      /*!
+       \brief Whether COVER_NODE is aLU inclusion with local bounds
+       */
+      static constexpr bool is_alu_local =
+          std::is_same<COVER_NODE, tchecker::covreach::cover_alu_local_t<NODE_PTR, STATE_PREDICATE>>::value;
+
+      /*!
+       \brief Whether COVER_NODE is aM inclusion with global bounds
+       */
+      static constexpr bool is_am_global =
+          std::is_same<COVER_NODE, tchecker::covreach::cover_am_global_t<NODE_PTR, STATE_PREDICATE>>::value;
+
+      /*!
+       \brief Whether COVER_NODE is aM inclusion with local bounds
+       */
+      static constexpr bool is_am_local =
+          std::is_same<COVER_NODE, tchecker::covreach::cover_am_local_t<NODE_PTR, STATE_PREDICATE>>::value;
+
+      /*!
+       \class scratch_maps_t
+       \brief Clock bounds maps of a thread for the local bounds (L and U, or M)
+       */
+      struct scratch_maps_t {
+        tchecker::clock_id_t clock_number = 0;          /*!< Number of clocks of the maps */
+        tchecker::clockbounds::map_t * map1 = nullptr;  /*!< L or M map */
+        tchecker::clockbounds::map_t * map2 = nullptr;  /*!< U map */
+
+        ~scratch_maps_t()
+        {
+          release();
+        }
+
+        void release()
+        {
+          if (map1 != nullptr)
+            tchecker::clockbounds::deallocate_map(map1);
+          if (map2 != nullptr)
+            tchecker::clockbounds::deallocate_map(map2);
+          map1 = nullptr;
+          map2 = nullptr;
+        }
+      };
+
+      /*!
+       \brief Accessor
+       \param clock_number : number of clocks
+       \return the scratch maps of the calling thread, over clock_number clocks
+       */
+      static scratch_maps_t & scratch(tchecker::clock_id_t clock_number)
+      {
+        static thread_local scratch_maps_t maps;
+        if ((maps.map1 == nullptr) || (maps.clock_number != clock_number)) {
+          maps.release();
+          maps.clock_number = clock_number;
+          maps.map1 = tchecker::clockbounds::allocate_map(clock_number);
+          maps.map2 = tchecker::clockbounds::allocate_map(clock_number);
+        }
+        return maps;
+      }
+
+      MODEL const & _model; /*!< Model, with the clock bounds maps */
+      STATE_PREDICATE _state_predicate; /*!< Predicate on discrete parts */
+      std::shared_ptr<tchecker_ext::covreach_ext::compressed_zone_store_t<NODE_PTR>> _compressed_zones; /*!< Compressed zones (or nullptr) */
+      tchecker::integer_t const * _l = nullptr; /*!< Global L bounds (aLU global) */
+      tchecker::integer_t const * _u = nullptr; /*!< Global U bounds (aLU global) */
+      tchecker::integer_t const * _m = nullptr; /*!< Global M bounds (aM global) */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_INTERN_HH
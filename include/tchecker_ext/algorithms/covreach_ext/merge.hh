@@ -0,0 +1,228 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_MERGE_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_MERGE_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/dbm.hh"
+#include "tchecker_ext/dbm/simd.hh"
+#include "tchecker_ext/utils/lock_stripes.hh"
+
+/*!
+ \file merge.hh
+ \brief Exact merging of the zones of nodes with the same discrete part
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class zone_merger_t
+     \brief Stored nodes by discrete part, one table per stripe of the nodes table
+     \tparam NODE_PTR : type of pointer to node
+     \note Before a node is inserted in the graph, its zone is merged with the zone of a stored node with
+     the same discrete part if their union is convex: the zone of the inserted node becomes the union. The
+     stored node is then included in the inserted one, and it is removed by covering as any other node.
+     This keeps exactly the same set of states with fewer nodes.
+     Nodes with the same discrete part are in the same stripe. The table of a stripe is only accessed under
+     the lock of this stripe
+     */
+    template <class NODE_PTR>
+    class zone_merger_t {
+    public:
+      /*!
+       \brief Type of nodes
+       */
+      using node_t = std::remove_reference_t<decltype(*std::declval<NODE_PTR const &>())>;
+
+      /*!
+       \brief Constructor
+       \post this has no table, see init()
+       */
+      zone_merger_t() = default;
+
+      zone_merger_t(tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> const &) = delete;
+      zone_merger_t(tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> &&) = delete;
+      ~zone_merger_t() = default;
+      tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> const &) = delete;
+      tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> &
+      operator= (tchecker_ext::covreach_ext::zone_merger_t<NODE_PTR> &&) = delete;
+
+      /*!
+       \brief Initialization
+       \param n_stripes : number of stripes of the nodes table
+       \post this has n_stripes empty tables
+       \note called by the graph that stores the nodes
+       */
+      void init(std::size_t n_stripes)
+      {
+        assert(n_stripes > 0);
+        _n_stripes = n_stripes;
+        _tables.reset(new tchecker_ext::cache_aligned_t<stripe_table_t>[n_stripes]);
+      }
+
+      /*!
+       \brief Merge
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node with a dense tight zone, not stored yet
+       \param hull : scratch vector
+       \param scratch : scratch vector
+       \pre stripe is locked by the caller, the zone of node is only referenced by node
+       \post if a stored active node with the discrete part of node and a dense zone (compressed zones are
+       skipped) has been found such that the union of their zones is convex, the zone of node is this union.
+       This is repeated as long as such a node is found
+       \return number of stored nodes whose zone has been merged into the zone of node
+       */
+      std::size_t merge(std::size_t stripe, std::size_t key, NODE_PTR const & node,
+                        std::vector<tchecker::dbm::db_t> & hull, std::vector<tchecker::dbm::db_t> & scratch)
+      {
+        assert(stripe < _n_stripes);
+        stripe_table_t & table = _tables[stripe].value;
+        auto it = table.nodes.find(key);
+        if (it == table.nodes.end())
+          return 0;
+
+        tchecker::clock_id_t const dim = node->zone().dim();
+        hull.resize(dim * dim);
+        scratch.resize(dim * dim);
+        std::size_t merged = 0;
+        for (bool found = true; found; ) {
+          found = false;
+          for (node_t * m : it->second) {
+            if (!m->is_active() || (m->zone_ptr().ptr() == nullptr))
+              continue;
+            if ((m->vloc() != node->vloc()) || (m->intvars_valuation() != node->intvars_valuation()))
+              continue;
+            tchecker::dbm::db_t const * dbm = node->zone().dbm();
+            tchecker::dbm::db_t const * mdbm = m->zone().dbm();
+            // Inclusions are decided by covering
+            if (tchecker_ext::dbm_ext::is_le(dbm, mdbm, dim) || tchecker_ext::dbm_ext::is_le(mdbm, dbm, dim))
+              continue;
+            if (!tchecker_ext::dbm_ext::exact_convex_union(hull.data(), scratch.data(), dbm, mdbm, dim))
+              continue;
+            std::copy(hull.begin(), hull.end(), node->zone_ptr()->dbm());
+            ++merged;
+            found = true;
+            break;
+          }
+        }
+        table.merged += merged;
+        return merged;
+      }
+
+      /*!
+       \brief Record an insertion
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node inserted in the graph
+       \pre stripe is locked by the caller
+       \post node is a candidate for merging
+       */
+      void inserted(std::size_t stripe, std::size_t key, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        _tables[stripe].value.nodes[key].push_back(node.ptr());
+      }
+
+      /*!
+       \brief Record a relocation
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node
+       \param moved : copy of node that replaces node in the graph
+       \pre stripe is locked by the caller (or no other thread accesses this)
+       \post if node was a candidate for merging, moved has replaced it
+       */
+      void relocated(std::size_t stripe, std::size_t key, NODE_PTR const & node, NODE_PTR const & moved)
+      {
+        assert(stripe < _n_stripes);
+        auto it = _tables[stripe].value.nodes.find(key);
+        if (it == _tables[stripe].value.nodes.end())
+          return;
+        std::replace(it->second.begin(), it->second.end(), node.ptr(), moved.ptr());
+      }
+
+      /*!
+       \brief Erase
+       \param stripe : stripe of node
+       \param key : hash value of the discrete part of node
+       \param node : a node
+       \pre stripe is locked by the caller
+       \post node is not a candidate for merging anymore
+       */
+      void erase(std::size_t stripe, std::size_t key, NODE_PTR const & node)
+      {
+        assert(stripe < _n_stripes);
+        auto & nodes = _tables[stripe].value.nodes;
+        auto it = nodes.find(key);
+        if (it == nodes.end())
+          return;
+        auto pos = std::find(it->second.begin(), it->second.end(), node.ptr());
+        if (pos == it->second.end())
+          return;
+        *pos = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty())
+          nodes.erase(it);
+      }
+
+      /*!
+       \brief Clear
+       \pre no other thread accesses this
+       \post all tables are empty
+       */
+      void clear()
+      {
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          _tables[s].value.nodes.clear();
+      }
+
+      /*!
+       \brief Accessor
+       \return number of stored nodes whose zone has been merged into the zone of an inserted node
+       \pre no other thread modifies this
+       */
+      std::size_t merged() const
+      {
+        std::size_t n = 0;
+        for (std::size_t s = 0; s < _n_stripes; ++s)
+          n += _tables[s].value.merged;
+        return n;
+      }
+
+    private:
+      /*!
+       \class stripe_table_t
+       \brief Stored nodes of one stripe
+       */
+      struct stripe_table_t {
+        std::unordered_map<std::size_t, std::vector<node_t *>> nodes; /*!< Stored nodes by hash value of their discrete part */
+        std::size_t merged = 0; /*!< Number of merged nodes */
+      };
+
+      std::size_t _n_stripes = 0; /*!< Number of stripes */
+      std::unique_ptr<tchecker_ext::cache_aligned_t<stripe_table_t>[]> _tables; /*!< One table per stripe */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_MERGE_HH
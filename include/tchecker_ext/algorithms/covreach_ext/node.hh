@@ -0,0 +1,193 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_NODE_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_NODE_HH
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "tchecker_ext/algorithms/covreach_ext/packed_discrete.hh"
+#include "tchecker_ext/dbm/compressed_dbm.hh"
+#include "tchecker_ext/utils/shared_objects.hh"
+
+/*!
+ \file node.hh
+ \brief Nodes of the graph with the fields of the extension
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class node_t
+     \brief Node of tchecker extended by the fields of the extension
+     \tparam NODE : type of node of tchecker (without reference counter, see tchecker::make_shared_t)
+     \note the constructors of NODE are inherited: the allocators of tchecker build nodes of this type as
+     they build nodes of type NODE. The fields of the extension are default-initialized, including when a
+     node is built from another node
+     \note the packed discrete part of a node is computed on first use (see pack()), which happens when the key
+     of the node is computed, while the node is only referenced by the worker that built it. It is read-only
+     afterwards
+     */
+    template <class NODE>
+    class node_t : public NODE {
+    public:
+      using NODE::NODE;
+
+      /*!
+       \brief Destructor
+       \post if this has been allocated by a compaction, the count of nodes of its arena has been decremented
+       */
+      ~node_t()
+      {
+        if (_arena_nodes != nullptr)
+          _arena_nodes->fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      /*!
+       \brief Accessor
+       \return handle of the compressed zone of this node, nullptr if its zone is not compressed
+       (see tchecker_ext::covreach_ext::compressed_zone_store_t)
+       */
+      inline tchecker_ext::dbm_ext::compressed_dbm_t const * & compressed_zone()
+      {
+        return _compressed_zone;
+      }
+
+      /*!
+       \brief Accessor
+       \return handle of the compressed zone of this node, nullptr if its zone is not compressed
+       */
+      inline tchecker_ext::dbm_ext::compressed_dbm_t const * compressed_zone() const
+      {
+        return _compressed_zone;
+      }
+
+      /*!
+       \brief Packing
+       \param packer : layout of packed discrete parts (enabled)
+       \pre the discrete part of this has been packed by packer, or this is only referenced by the caller
+       \post the discrete part of this has been packed by packer (only the first time)
+       \return the packed discrete part of this
+       */
+      tchecker_ext::covreach_ext::packed_discrete_t const & pack(tchecker_ext::covreach_ext::discrete_packer_t const & packer)
+      {
+        if (!_packed) {
+          packer.pack(*this, _packed_discrete);
+          _packed = true;
+        }
+        return _packed_discrete;
+      }
+
+      /*!
+       \brief Accessor
+       \return true if the discrete part of this has been packed, false otherwise
+       */
+      inline bool is_packed() const
+      {
+        return _packed;
+      }
+
+      /*!
+       \brief Accessor
+       \return the packed discrete part of this
+       \pre the discrete part of this has been packed (checked by assertion)
+       */
+      inline tchecker_ext::covreach_ext::packed_discrete_t const & packed_discrete() const
+      {
+        assert(_packed);
+        return _packed_discrete;
+      }
+
+      /*!
+       \brief Copy the packed discrete part of a node
+       \param n : a node with the same discrete part as this
+       \post this has the packed discrete part of n, if n has one
+       \note the constructors of this do not copy it
+       */
+      inline void copy_packed_discrete(tchecker_ext::covreach_ext::node_t<NODE> const & n)
+      {
+        _packed_discrete = n._packed_discrete;
+        _packed = n._packed;
+      }
+
+      /*!
+       \brief Accessor
+       \return count of the nodes of the compaction arena this node has been allocated from, nullptr if this
+       node has not been allocated by a compaction
+       \note the count is decremented when this node is destructed, so that the arena can be freed once it
+       is drained
+       */
+      inline std::atomic<std::size_t> * & arena_nodes()
+      {
+        return _arena_nodes;
+      }
+
+    private:
+      tchecker_ext::dbm_ext::compressed_dbm_t const * _compressed_zone = nullptr; /*!< Compressed zone (or nullptr) */
+      std::atomic<std::size_t> * _arena_nodes = nullptr; /*!< Count of the nodes of the compaction arena (or nullptr) */
+      tchecker_ext::covreach_ext::packed_discrete_t _packed_discrete; /*!< Packed discrete part (if packed) */
+      bool _packed = false; /*!< Whether the discrete part has been packed */
+    };
+
+    namespace details {
+
+      /*!
+       \class rebind_t
+       \brief Type T where type FROM is replaced by type TO, at any depth of template arguments
+       \note used to build the allocators and the transition system of a model over extended nodes from
+       those over the nodes of tchecker. Only type template arguments are rebound
+       */
+      template <class T, class FROM, class TO>
+      struct rebind_t {
+        using type = std::conditional_t<std::is_same<T, FROM>::value, TO, T>;
+      };
+
+      template <template <class ...> class TT, class ... ARGS, class FROM, class TO>
+      struct rebind_t<TT<ARGS...>, FROM, TO> {
+        using type = std::conditional_t<std::is_same<TT<ARGS...>, FROM>::value,
+                                        TO,
+                                        TT<typename tchecker_ext::covreach_ext::details::rebind_t<ARGS, FROM, TO>::type...>>;
+      };
+
+      /*!
+       \class unshared_t
+       \brief Type of objects of a shared type (see tchecker::make_shared_t)
+       */
+      template <class SHARED>
+      struct unshared_t;
+
+      template <template <class ...> class TT, class T, class ... ARGS>
+      struct unshared_t<TT<T, ARGS...>> {
+        using type = T;
+      };
+
+      /*!
+       \class atomic_shared_t
+       \brief Shared type with an atomic reference counter, for objects of a shared type (see
+       tchecker_ext::make_atomic_shared_t)
+       */
+      template <class SHARED>
+      struct atomic_shared_t;
+
+      template <template <class ...> class TT, class T, class ... ARGS>
+      struct atomic_shared_t<TT<T, ARGS...>> {
+        using type = tchecker_ext::make_atomic_shared_t<T, ARGS...>;
+      };
+
+    } // end of namespace details
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_NODE_HH
@@ -39,7 +39,21 @@ namespace tchecker_ext {
       options_t(tchecker::range_t<MAP_ITERATOR> const & range, tchecker::log_t & log)
       : tchecker::covreach::options_t(),
         _num_threads(1),
-        _n_notify(0)
+        _n_notify(0),
+        _reach_only(false),
+        _lock_stripes(0),
+        _lock_policy(LOCK_TAS),
+        _atomic_refcount(false),
+        _huge_pages(false),
+        _intern_discrete(false),
+        _pack_discrete(false),
+        _intern_zones(false),
+        _compress_zones(false),
+        _merge_zones(false),
+        _federation_cover(false),
+        _memory_limit(0),
+        _compaction_threshold(0.0),
+        _fast_exit(false)
       {
         auto it = range.begin(), end = range.end();
         for ( ; it != end; ++it )
@@ -72,6 +86,17 @@ namespace tchecker_ext {
        */
       tchecker_ext::covreach_ext::options_t & operator= (tchecker_ext::covreach_ext::options_t &&);
   
+      /*!
+       \brief Type of locks protecting the nodes table and the waiting container
+       */
+      enum lock_policy_t {
+        LOCK_TAS,        /*!< tchecker_ext::spinlock_t */
+        LOCK_TTAS,       /*!< tchecker_ext::ttas_lock_t */
+        LOCK_TICKET,     /*!< tchecker_ext::ticket_lock_t */
+        LOCK_MCS,        /*!< tchecker_ext::mcs_lock_t */
+        LOCK_FUTEX,      /*!< tchecker_ext::futex_lock_t */
+      };
+      
       /*!
        \brief Options description
        \param os : output stream
@@ -91,6 +116,98 @@ namespace tchecker_ext {
        \return number of explorations before notification
        */
       unsigned int n_notify() const;
+  
+      /*!
+       \brief Accessor
+       \return true if only reachability is decided (no edges are stored in the graph), false otherwise
+       */
+      bool reach_only() const;
+  
+      /*!
+       \brief Accessor
+       \return number of locks protecting the nodes table, 0 for one lock per bucket
+       */
+      std::size_t lock_stripes() const;
+  
+      /*!
+       \brief Accessor
+       \return type of locks of the nodes table and the waiting container
+       \note only relevant if more than one thread is used
+       */
+      enum lock_policy_t lock_policy() const;
+  
+      /*!
+       \brief Accessor
+       \return true if the reference counters of the nodes are atomic, false otherwise
+       \note only relevant if more than one thread is used
+       */
+      bool atomic_refcount() const;
+  
+      /*!
+       \brief Accessor
+       \return true if the arenas of compressed zones should be backed by transparent huge pages, false otherwise
+       */
+      bool huge_pages() const;
+  
+      /*!
+       \brief Accessor
+       \return true if stored nodes share equal tuples of locations and integer valuations, false otherwise
+       */
+      bool intern_discrete() const;
+  
+      /*!
+       \brief Accessor
+       \return true if the discrete parts of nodes are hashed and interned from their bit-packed encoding,
+       false otherwise
+       */
+      bool pack_discrete() const;
+  
+      /*!
+       \brief Accessor
+       \return true if stored nodes share equal zones, false otherwise
+       */
+      bool intern_zones() const;
+  
+      /*!
+       \brief Accessor
+       \return true if the zones of expanded nodes are stored as minimal sets of constraints, false otherwise
+       */
+      bool compress_zones() const;
+  
+      /*!
+       \brief Accessor
+       \return true if zones of nodes with the same discrete part are merged when their union is convex,
+       false otherwise
+       */
+      bool merge_zones() const;
+  
+      /*!
+       \brief Accessor
+       \return true if nodes are also covered by the union of the zones of the stored nodes with the same
+       discrete part (-c federation, inclusion covering), false otherwise
+       */
+      bool federation_cover() const;
+  
+      /*!
+       \brief Accessor
+       \return memory limit in MB, 0 if memory is not limited
+       \note a budget for the node payload of the graph (see graph_t::live_bytes()), not a limit of the
+       resident memory of the process
+       */
+      std::size_t memory_limit() const;
+  
+      /*!
+       \brief Accessor
+       \return fraction of removed nodes above which the node pools are compacted, 0 if they are never compacted
+       */
+      double compaction_threshold() const;
+  
+      /*!
+       \brief Accessor
+       \return true if the graph is not freed once the results have been output (its memory is returned
+       when the process exits), false otherwise
+       */
+      bool fast_exit() const;
       
       /*!
        \brief Check that mandatory options have been set
@@ -121,6 +238,19 @@ namespace tchecker_ext {
         {"threads",      required_argument, 0, 't'},
         {"block-size",   required_argument, 0, 0},
         {"table-size",   required_argument, 0, 0},
+        {"reach-only",   no_argument,       0, 0},
+        {"lock-stripes", required_argument, 0, 0},
+        {"lock",         required_argument, 0, 0},
+        {"atomic-refcount", no_argument,    0, 0},
+        {"huge-pages",   no_argument,       0, 0},
+        {"intern-discrete", no_argument,    0, 0},
+        {"pack-discrete", no_argument,      0, 0},
+        {"intern-zones", no_argument,       0, 0},
+        {"compress-zones", no_argument,     0, 0},
+        {"merge-zones",  no_argument,       0, 0},
+        {"memory-limit", required_argument, 0, 0},
+        {"compact",      required_argument, 0, 0},
+        {"fast-exit",    no_argument,       0, 0},
         {0, 0, 0, 0}
       };
       
@@ -152,9 +282,55 @@ namespace tchecker_ext {
        \post n_notify is updated
        */
       void set_n_notify(std::string const & value, tchecker::log_t & log);
+  
+      /*!
+       \brief Set number of lock stripes
+       \param value : option value
+       \param log : logging facility
+       \post number of lock stripes is updated
+       */
+      void set_lock_stripes(std::string const & value, tchecker::log_t & log);
+  
+      /*!
+       \brief Set lock policy
+       \param value : option value
+       \param log : logging facility
+       \post lock policy is updated
+       */
+      void set_lock_policy(std::string const & value, tchecker::log_t & log);
+  
+      /*!
+       \brief Set memory limit
+       \param value : option value
+       \param log : logging facility
+       \post memory limit is updated
+       */
+      void set_memory_limit(std::string const & value, tchecker::log_t & log);
+  
+      /*!
+       \brief Set compaction threshold
+       \param value : option value
+       \param log : logging facility
+       \post compaction threshold is updated
+       */
+      void set_compaction_threshold(std::string const & value, tchecker::log_t & log);
       
       unsigned int _num_threads; /*!< Number of worker threads */
       unsigned int _n_notify; /*! Number of states to explore before notifying */
+      bool _reach_only; /*!< Only decide reachability: the graph stores no edges */
+      std::size_t _lock_stripes; /*!< Number of locks protecting the nodes table (0: one per bucket) */
+      enum lock_policy_t _lock_policy; /*!< Type of locks of the nodes table and the waiting container */
+      bool _atomic_refcount; /*!< Reference counters of the nodes are atomic */
+      bool _huge_pages; /*!< Back the arenas of compressed zones by transparent huge pages */
+      bool _intern_discrete; /*!< Stored nodes share equal discrete parts */
+      bool _pack_discrete; /*!< Discrete parts are hashed and interned from their bit-packed encoding */
+      bool _intern_zones; /*!< Stored nodes share equal zones */
+      bool _compress_zones; /*!< Zones of expanded nodes are stored as minimal sets of constraints */
+      bool _merge_zones; /*!< Zones with a convex union are merged */
+      bool _federation_cover; /*!< Nodes are covered by the union of the zones of the stored nodes */
+      std::size_t _memory_limit; /*!< Memory limit in MB (0: no limit) */
+      double _compaction_threshold; /*!< Fraction of removed nodes above which node pools are compacted (0: never) */
+      bool _fast_exit; /*!< The graph is not freed once the results have been output */
     };
     
   } // end of namespace covreach_ext
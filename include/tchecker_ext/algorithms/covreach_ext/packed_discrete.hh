@@ -0,0 +1,248 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_PACKED_DISCRETE_HH
+#define TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_PACKED_DISCRETE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tchecker/basictypes.hh"
+
+/*!
+ \file packed_discrete.hh
+ \brief Bit-packed encoding of the discrete part (tuple of locations and valuation of integer variables)
+ of states
+ */
+
+namespace tchecker_ext {
+
+  namespace covreach_ext {
+
+    /*!
+     \class packed_discrete_t
+     \brief Discrete part of a state packed into two 64 bits words
+     \note unused bits are 0, so that two packed discrete parts are equal iff their words are equal
+     */
+    struct packed_discrete_t {
+      std::uint64_t words[2] = {0, 0}; /*!< Packed fields */
+
+      /*!
+       \brief Equality
+       \param p : packed discrete part
+       \return true if this and p encode the same discrete part, false otherwise
+       */
+      inline bool operator== (tchecker_ext::covreach_ext::packed_discrete_t const & p) const
+      {
+        return ((words[0] ^ p.words[0]) | (words[1] ^ p.words[1])) == 0;
+      }
+
+      /*!
+       \brief Disequality
+       \param p : packed discrete part
+       \return false if this and p encode the same discrete part, true otherwise
+       */
+      inline bool operator!= (tchecker_ext::covreach_ext::packed_discrete_t const & p) const
+      {
+        return !(*this == p);
+      }
+
+      /*!
+       \brief Hash value
+       \return hash value of the two words (finalizer of MurmurHash3 on their combination)
+       */
+      inline std::size_t hash() const
+      {
+        std::uint64_t h = words[0] ^ (words[1] * 0x9e3779b97f4a7c15ULL);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+      }
+    };
+
+
+    /*!
+     \class packed_discrete_hash_t
+     \brief Hash functor over packed discrete parts
+     */
+    struct packed_discrete_hash_t {
+      inline std::size_t operator() (tchecker_ext::covreach_ext::packed_discrete_t const & p) const
+      {
+        return p.hash();
+      }
+    };
+
+
+    /*!
+     \class discrete_packer_t
+     \brief Layout of the packed discrete parts of the states of a model
+     \note The width of a field is derived from the declared range of its integer variable, or from the
+     number of locations of its process. Locations are encoded by their rank in their process, integer
+     variables by their offset to their lower bound. Fields do not straddle words. If the fields do not
+     fit into two words, the packer is disabled and states are hashed and compared as usual
+     \note tchecker guarantees that the values of integer variables are within their declared bounds in all
+     states that are stored (other states are not OK states)
+     */
+    class discrete_packer_t {
+    public:
+      /*!
+       \brief Constructor
+       \tparam MODEL : type of model, should derive from tchecker::ta::model_t
+       \param model : a model
+       \post this is the layout of the discrete parts of the states of model. this is disabled if the
+       fields do not fit into two words
+       */
+      template <class MODEL>
+      explicit discrete_packer_t(MODEL const & model)
+      : _bits(0),
+        _enabled(true)
+      {
+        auto const & system = model.system();
+
+        // Rank of every location in its process
+        std::vector<std::uint32_t> locations_count(system.processes_count(), 0);
+        for (auto const * loc : system.locations()) {
+          if (loc->id() >= _loc_ranks.size())
+            _loc_ranks.resize(loc->id() + 1, 0);
+          _loc_ranks[loc->id()] = locations_count[loc->pid()]++;
+        }
+
+        unsigned int free[2] = {64, 64};
+        for (std::uint32_t count : locations_count)
+          _loc_fields.push_back(make_field(count == 0 ? 0 : count - 1, 0, free));
+
+        auto const & intvars = model.flattened_integer_variables();
+        for (tchecker::intvar_id_t id = 0; id < intvars.size(); ++id) {
+          auto const & info = intvars.info(id);
+          std::uint64_t const range = static_cast<std::uint64_t>(static_cast<std::int64_t>(info.max()) -
+                                                                 static_cast<std::int64_t>(info.min()));
+          _intvar_fields.push_back(make_field(range, info.min(), free));
+        }
+      }
+
+      /*!
+       \brief Accessor
+       \return true if the discrete parts of states fit into two words, false otherwise
+       */
+      inline bool enabled() const
+      {
+        return _enabled;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of bits of the packed discrete parts
+       */
+      inline unsigned int bits() const
+      {
+        return _bits;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of 64 bits words of the packed discrete parts
+       */
+      inline unsigned int words() const
+      {
+        return (_bits <= 64 ? 1 : 2);
+      }
+
+      /*!
+       \brief Packing
+       \tparam STATE : type of state, should derive from tchecker::ta::details::state_t
+       \param s : a state of the model of this
+       \param p : packed discrete part
+       \pre this is enabled, the integer variables of s are within their declared bounds (checked by assertion)
+       \post p is the discrete part of s packed
+       */
+      template <class STATE>
+      void pack(STATE const & s, tchecker_ext::covreach_ext::packed_discrete_t & p) const
+      {
+        assert(_enabled);
+        auto const & vloc = s.vloc();
+        auto const & intval = s.intvars_valuation();
+        assert(vloc.size() == _loc_fields.size());
+        assert(intval.size() == _intvar_fields.size());
+        p.words[0] = 0;
+        p.words[1] = 0;
+        for (std::size_t pid = 0; pid < _loc_fields.size(); ++pid) {
+          field_t const & f = _loc_fields[pid];
+          p.words[f.word] |= static_cast<std::uint64_t>(_loc_ranks[vloc[pid]->id()]) << f.shift;
+        }
+        for (std::size_t id = 0; id < _intvar_fields.size(); ++id) {
+          field_t const & f = _intvar_fields[id];
+          std::uint64_t const v = static_cast<std::uint64_t>(static_cast<std::int64_t>(intval[id]) - f.min);
+          assert((f.bits == 64) || (v < (std::uint64_t{1} << f.bits)));
+          p.words[f.word] |= v << f.shift;
+        }
+      }
+
+    private:
+      /*!
+       \class field_t
+       \brief Position of a value in the packed words
+       */
+      struct field_t {
+        std::int64_t min;     /*!< Value encoded by 0 */
+        std::uint8_t word;    /*!< Index of the word */
+        std::uint8_t shift;   /*!< Position of the least significant bit in the word */
+        std::uint8_t bits;    /*!< Width */
+      };
+
+      /*!
+       \brief Width
+       \param range : largest value to encode
+       \return number of bits needed to encode the values in [0, range]
+       */
+      static unsigned int width(std::uint64_t range)
+      {
+        unsigned int w = 0;
+        for ( ; range != 0; range >>= 1)
+          ++w;
+        return w;
+      }
+
+      /*!
+       \brief Allocate a field
+       \param range : largest value to encode (once offset by min)
+       \param min : value encoded by 0
+       \param free : number of free bits in each word
+       \return a field of free bits in the first word with enough of them
+       \post free has been updated, this has been disabled if no word has enough free bits
+       */
+      field_t make_field(std::uint64_t range, std::int64_t min, unsigned int (&free)[2])
+      {
+        unsigned int const bits = width(range);
+        _bits += bits;
+        for (std::uint8_t w = 0; w < 2; ++w) {
+          if (free[w] >= bits) {
+            field_t f{min, w, static_cast<std::uint8_t>((64 - free[w]) % 64), static_cast<std::uint8_t>(bits)};
+            free[w] -= bits;
+            return f;
+          }
+        }
+        _enabled = false;
+        return field_t{min, 0, 0, static_cast<std::uint8_t>(bits)};
+      }
+
+      std::vector<std::uint32_t> _loc_ranks; /*!< Rank of locations in their process, by location identifier */
+      std::vector<field_t> _loc_fields; /*!< Fields of the locations, by process identifier */
+      std::vector<field_t> _intvar_fields; /*!< Fields of the flattened integer variables */
+      unsigned int _bits; /*!< Total width of the fields */
+      bool _enabled; /*!< Whether the fields fit into two words */
+    };
+
+  } // end of namespace covreach_ext
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_ALGORITHMS_COVREACH_EXT_PACKED_DISCRETE_HH
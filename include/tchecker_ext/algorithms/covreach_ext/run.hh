@@ -14,6 +14,16 @@
 #include "tchecker_ext/algorithms/covreach_ext/algorithm.hh"
 #include "tchecker_ext/algorithms/covreach_ext/graph.hh"
 #include "tchecker_ext/algorithms/covreach_ext/builder.hh"
+#include "tchecker_ext/algorithms/covreach_ext/csr_graph.hh"
+#include "tchecker_ext/algorithms/covreach_ext/eviction.hh"
+#include "tchecker_ext/algorithms/covreach_ext/federation.hh"
+#include "tchecker_ext/algorithms/covreach_ext/intern.hh"
+#include "tchecker_ext/algorithms/covreach_ext/merge.hh"
+#include "tchecker_ext/algorithms/covreach_ext/node.hh"
+#include "tchecker_ext/algorithms/covreach_ext/packed_discrete.hh"
+#include "tchecker_ext/dbm/simd.hh"
+#include "tchecker_ext/utils/locks.hh"
+#include "tchecker_ext/utils/memory.hh"
 
 
 /*!
@@ -36,21 +46,66 @@ namespace tchecker_ext {
            \brief Model for covering reachability over zone graphs of timed automata
            \note Allocator, Builder and Graph have changed compared to the original
            single threaded version
+           \note Nodes carry the fields of the extension (see tchecker_ext::covreach_ext::node_t): the
+           node allocator, the transition system and the node pointers of tchecker are rebound to them
+           \note Discrete parts are compared by pointer first, as nodes can share them (see
+           tchecker_ext::covreach_ext::discrete_intern_table_t), then by their packed encoding if nodes
+           store one
+           \tparam LOCK : type of the locks of the graph and the waiting container
+           \tparam ATOMIC_REFCOUNT : whether the reference counters of the nodes are atomic (see
+           tchecker_ext::make_atomic_shared_t). The graph then releases nodes without locking when no side table
+           has to know about their last reference (see tchecker_ext::covreach_ext::graph_t::release_node())
            */
-          template <class ZONE_SEMANTICS>
+          template <class ZONE_SEMANTICS, class LOCK=tchecker_ext::spinlock_t, bool ATOMIC_REFCOUNT=false>
           class algorithm_model_t: public tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>{
+            using base_model_t = tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>;
+            using base_shared_node_t =
+                std::remove_reference_t<decltype(*std::declval<typename base_model_t::node_ptr_t const &>())>;
+            using base_node_t = typename tchecker_ext::covreach_ext::details::unshared_t<base_shared_node_t>::type;
+            
+            // Nodes of tchecker are replaced by extended nodes, then their shared type by the atomic one if needed
+            template <class T>
+            using rebind_node_t = typename tchecker_ext::covreach_ext::details::rebind_t<T, base_node_t,
+                                                                                        tchecker_ext::covreach_ext::node_t<base_node_t>>::type;
+            using ext_shared_node_t = rebind_node_t<base_shared_node_t>;
+            using shared_node_t = std::conditional_t<ATOMIC_REFCOUNT,
+                typename tchecker_ext::covreach_ext::details::atomic_shared_t<ext_shared_node_t>::type,
+                ext_shared_node_t>;
+            
+            template <class T>
+            using rebind_t = typename tchecker_ext::covreach_ext::details::rebind_t<rebind_node_t<T>, ext_shared_node_t,
+                                                                                   shared_node_t>::type;
           public:
             
-            using ts_allocator_t = tchecker_ext::threaded_ts::allocator_t<
-                typename tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>::node_allocator_t,
-                typename tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>::transition_allocator_t>;
+            using node_ptr_t = rebind_t<typename base_model_t::node_ptr_t>;
+            
+            using node_allocator_t = rebind_t<typename base_model_t::node_allocator_t>;
+            
+            using ts_t = rebind_t<typename base_model_t::ts_t>;
+            
+            using ts_allocator_t = tchecker_ext::threaded_ts::allocator_t<node_allocator_t,
+                                                                          typename base_model_t::transition_allocator_t>;
             
-            using graph_t  = tchecker_ext::covreach_ext::graph_t<typename tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>::key_t,
-                                                                 typename tchecker::covreach::details::zg::ta::algorithm_model_t<ZONE_SEMANTICS>::ts_t,
-                                                                 ts_allocator_t>;
+            using graph_t  = tchecker_ext::covreach_ext::graph_t<typename base_model_t::key_t,
+                                                                 ts_t,
+                                                                 ts_allocator_t,
+                                                                 LOCK>;
             
             using builder_allocator_t =
                 tchecker_ext::threaded_ts::threaded_builder_allocator_t<ts_allocator_t >;
+            
+            using state_predicate_t = tchecker_ext::covreach_ext::interned_state_predicate_t<
+                rebind_t<typename base_model_t::state_predicate_t>>;
+            
+            /*!
+             \brief Key of a node
+             \param node : a node
+             \return hash value of the discrete part of node
+             */
+            static typename base_model_t::key_t node_to_key(node_ptr_t const & node)
+            {
+              return tchecker::ta::details::hash_value(*node);
+            }
           };
 
         } // end of namespace ta
@@ -108,7 +163,7 @@ namespace tchecker_ext {
       <template <class NODE_PTR, class STATE_PREDICATE> class COVER_NODE,
       class ALGORITHM_MODEL,
       template <class N, class E, class NO, class EO> class GRAPH_OUTPUTTER,
-      template <class NPTR> class WAITING
+      template <class NPTR, class LOCK> class WAITING
       >
       void run(tchecker::parsing::system_declaration_t const & sysdecl,
                tchecker_ext::covreach_ext::options_t const & options,
@@ -119,12 +174,40 @@ namespace tchecker_ext {
         using graph_t = typename ALGORITHM_MODEL::graph_t;
         using node_ptr_t = typename ALGORITHM_MODEL::node_ptr_t;
         using state_predicate_t = typename ALGORITHM_MODEL::state_predicate_t;
-        using cover_node_t = COVER_NODE<node_ptr_t, state_predicate_t>;
+        using cover_node_t = tchecker_ext::covreach_ext::interned_cover_node_t<COVER_NODE<node_ptr_t, state_predicate_t>,
+                                                                               node_ptr_t, state_predicate_t, model_t>;
         
         using builder_allocator_t = typename ALGORITHM_MODEL::builder_allocator_t;
   
         size_t time_used_verif;
         
+        // Edge dependent outputs are refused before anything is explored
+        if (options.reach_only() && (options.output_format() == tchecker_ext::covreach_ext::options_t::DOT)) {
+          log.error("DOT output is not available in reachability-only mode, the graph has no edges");
+          return;
+        }
+        // Compressed zones are only compared by inclusion, and are not output
+        if (options.compress_zones() &&
+            (!options.reach_only() || (options.node_covering() != tchecker::covreach::options_t::INCLUSION))) {
+          log.error("compressed zones are only available in reachability-only mode with inclusion covering");
+          return;
+        }
+        // Evicted nodes are removed with their edges
+        if ((options.memory_limit() > 0) && !options.reach_only()) {
+          log.error("memory limit is only available in reachability-only mode");
+          return;
+        }
+        // A node covered by a federation has no covering node to redirect its edges to
+        if (options.federation_cover() && !options.reach_only()) {
+          log.error("covering by federations is only available in reachability-only mode");
+          return;
+        }
+        // Federations are built from dense zones, compressed zones are skipped
+        if (options.federation_cover() && options.compress_zones()) {
+          log.error("covering by federations is not available with compressed zones");
+          return;
+        }
+        
         model_t model(sysdecl, log);
         ts_t ts(model);
         
@@ -136,7 +219,17 @@ namespace tchecker_ext {
         
         // Depending on the extrapolation, cover_node is modified
         // compared to the standard version
-        cover_node_t cover_node(ALGORITHM_MODEL::state_predicate_args(model), ALGORITHM_MODEL::zone_predicate_args(model));
+        // Under a memory limit, zones are compressed under pressure whenever they can be
+        std::shared_ptr<tchecker_ext::covreach_ext::compressed_zone_store_t<node_ptr_t>> compressed_zones{nullptr};
+        if (options.compress_zones() ||
+            ((options.memory_limit() > 0) && (options.node_covering() == tchecker::covreach::options_t::INCLUSION)))
+          compressed_zones = std::make_shared<tchecker_ext::covreach_ext::compressed_zone_store_t<node_ptr_t>>(options.huge_pages());
+        std::shared_ptr<tchecker_ext::covreach_ext::cold_node_evictor_t<node_ptr_t>> evictor{nullptr};
+        if (options.memory_limit() > 0)
+          evictor = std::make_shared<tchecker_ext::covreach_ext::cold_node_evictor_t<node_ptr_t>>
+              (options.memory_limit() * 1024 * 1024);
+        cover_node_t cover_node(model, ALGORITHM_MODEL::state_predicate_args(model), ALGORITHM_MODEL::zone_predicate_args(model),
+                                compressed_zones);
         
         tchecker::label_index_t label_index(model.system().labels());
         for (std::string const & label : options.accepting_labels()) {
@@ -149,24 +242,83 @@ namespace tchecker_ext {
         tchecker::covreach::accepting_labels_t<node_ptr_t>
             accepting_labels(label_index, options.accepting_labels());
         
+        // Nodes are keyed by their packed discrete part if it fits into two words, it is stored in the node
+        std::shared_ptr<tchecker_ext::covreach_ext::discrete_packer_t const> packer{nullptr};
+        typename graph_t::node_to_key_t node_to_key = ALGORITHM_MODEL::node_to_key;
+        if (options.pack_discrete()) {
+          auto layout = std::make_shared<tchecker_ext::covreach_ext::discrete_packer_t>(model);
+          if (layout->enabled()) {
+            packer = layout;
+            node_to_key = [layout] (node_ptr_t const & node) { return node->pack(*layout).hash(); };
+          }
+          else
+            log.warning("discrete parts need " + std::to_string(layout->bits()) +
+                        " bits, more than two words: they are not packed");
+        }
+        
         tchecker::gc_t gc;
         
-        graph_t graph(gc,
+        // With fast exit, the graph and the builder allocators are left to the operating system
+        std::unique_ptr<graph_t> graph_ptr(new graph_t(gc,
                       std::tuple<tchecker::gc_t &, std::tuple<model_t &, std::size_t>, std::tuple<>>
                       (gc, std::tuple<model_t &, std::size_t>(model, options.block_size()), std::make_tuple()),
                       options.block_size(),
                       options.nodes_table_size(),
-                      ALGORITHM_MODEL::node_to_key,
-                      cover_node);
+                      options.lock_stripes(),
+                      node_to_key,
+                      cover_node,
+                      !options.reach_only(),
+                      options.intern_discrete(),
+                      options.intern_zones(),
+                      compressed_zones,
+                      options.compress_zones(),
+                      evictor));
+        graph_t & graph = *graph_ptr;
+        
+        if (packer)
+          graph.set_discrete_packer(packer);
+        std::shared_ptr<tchecker_ext::covreach_ext::zone_merger_t<node_ptr_t>> merger{nullptr};
+        if (options.merge_zones()) {
+          merger = std::make_shared<tchecker_ext::covreach_ext::zone_merger_t<node_ptr_t>>();
+          graph.set_zone_merger(merger);
+        }
+        std::shared_ptr<tchecker_ext::covreach_ext::federation_store_t<node_ptr_t>> federations{nullptr};
+        if (options.federation_cover()) {
+          federations = std::make_shared<tchecker_ext::covreach_ext::federation_store_t<node_ptr_t>>();
+          graph.set_federation_store(federations);
+        }
+        
+        // Compactions relocate the nodes to arenas of the graph
+        if (options.compaction_threshold() > 0.0)
+          graph.enable_compaction(gc, std::tuple<model_t &, std::size_t>(model, options.block_size()),
+                                  options.compaction_threshold());
+        
+        // With several threads, each worker allocates its edges from its own arena
+        if ((options.num_threads() > 1) && !options.reach_only())
+          graph.enable_edge_arenas(gc, options.num_threads(), options.block_size());
         
         // Construct the helper allocator
-        // Each builder allocator has its own transition (singleton) allocator, but all share the
-        // node allocator with the graph
-        std::deque<builder_allocator_t> builder_alloc_vec;
+        // Builders allocate no transition. With several threads, each builder allocator has its own
+        // node arena, otherwise the node allocator of the graph is used
+        std::unique_ptr<std::deque<builder_allocator_t>> builder_alloc_ptr(new std::deque<builder_allocator_t>);
+        std::deque<builder_allocator_t> & builder_alloc_vec = *builder_alloc_ptr;
         for (unsigned int i=0; i<options.num_threads(); ++i){
-          builder_alloc_vec.emplace_back(gc, graph.ts_allocator(), std::make_tuple());
+          if (options.num_threads() == 1)
+            builder_alloc_vec.emplace_back(graph.ts_allocator());
+          else
+            builder_alloc_vec.emplace_back(gc, graph.ts_allocator(),
+                                           std::tuple<model_t &, std::size_t>(model, options.block_size()));
         }
         
+        // Nodes can live in the arenas of the builder allocators: free them after the graph
+        // (nodes are released in parallel in reachability-only mode only, see graph_t::clear(unsigned int))
+        auto free_all = [&] () {
+          graph.clear(options.num_threads());
+          graph.free_all();
+          for (builder_allocator_t & builder_alloc : builder_alloc_vec)
+            builder_alloc.free_all();
+        };
+        
         gc.start();
         
         enum tchecker::covreach::outcome_t outcome;
@@ -183,12 +335,13 @@ namespace tchecker_ext {
         }
         catch (...) {
           gc.stop();
-          graph.clear();
-          graph.free_all();
+          free_all();
           throw;
         }
   
-        graph.edge_check_time();
+        if (graph.store_edges()){
+          graph.edge_check_time();
+        }
         
         std::cout << "REACHABLE " << (outcome == tchecker::covreach::REACHABLE ? "true" : "false") << std::endl;
         
@@ -197,23 +350,90 @@ namespace tchecker_ext {
           std::cout << "Total stats are " << std::endl << options.num_threads() << std::endl;
           
           std::cout << "STORED_NODES " << graph.nodes_count() << std::endl;
+          std::cout << "SIMD_KERNELS " << tchecker_ext::dbm_ext::simd_level_name(tchecker_ext::dbm_ext::simd_level())
+                    << std::endl;
+          if (packer) {
+            std::cout << "PACKED_DISCRETE_BITS " << packer->bits() << std::endl;
+            std::cout << "PACKED_DISCRETE_WORDS " << packer->words() << std::endl;
+          }
+          if (graph.intern_discrete()) {
+            std::cout << "CANONICAL_DISCRETE_PARTS " << graph.discrete_table().canonical_count() << std::endl;
+            std::cout << "SHARED_DISCRETE_PARTS " << graph.discrete_table().shared_count() << std::endl;
+          }
+          if (graph.intern_zones()) {
+            std::cout << "CANONICAL_ZONES " << graph.zone_table().canonical_count() << std::endl;
+            std::cout << "SHARED_ZONES " << graph.zone_table().shared_count() << std::endl;
+            std::cout << "SHARED_ZONES_BYTES_SAVED " << graph.zone_table().saved_bytes() << std::endl;
+          }
+          if (compressed_zones) {
+            std::cout << "COMPRESSED_ZONES " << compressed_zones->count() << std::endl;
+            std::cout << "COMPRESSED_ZONES_ARENA_BYTES " << compressed_zones->arena_bytes() << std::endl;
+            std::cout << "COMPRESSED_ZONES_ARENA_RESERVED " << compressed_zones->reserved_bytes() << std::endl;
+            std::cout << "COMPRESSED_ZONES_ARENA_OCCUPANCY " << compressed_zones->occupancy() << std::endl;
+            std::cout << "COMPRESSED_ZONES_BYTES_SAVED " << compressed_zones->saved_bytes() << std::endl;
+          }
+          if (merger) {
+            std::cout << "MERGED_NODES " << merger->merged() << std::endl;
+          }
+          if (federations) {
+            std::cout << "FEDERATION_COVERED_NODES " << federations->covered_count() << std::endl;
+          }
+          if (options.compaction_threshold() > 0.0) {
+            std::cout << "COMPACTIONS " << graph.compactions() << std::endl;
+            std::cout << "RELOCATED_NODES " << graph.relocated_nodes() << std::endl;
+          }
+          if (evictor) {
+            std::cout << "NODE_PAYLOAD_BYTES " << graph.live_bytes() << std::endl;
+            std::cout << "MEMORY_PRESSURE_PASSES " << evictor->pressure_passes() << std::endl;
+            std::cout << "COLD_NODES_COMPRESSED " << evictor->compressed() << std::endl;
+            std::cout << "EVICTED_NODES " << evictor->evicted() << std::endl;
+            std::cout << "REEXPLORED_NODES " << evictor->reexplored() << std::endl;
+          }
           std::cout << stats << std::endl;
+          std::cout << tchecker_ext::memory::usage();
           std::cerr << "verif time " << time_used_verif << " n_threads " << options.num_threads()
                     << " visited nodes per thread and second "
                     << ((double)stats.visited_nodes())/((double)time_used_verif*options.num_threads());
         }
         
+        gc.stop();
+        
         if (options.output_format() == tchecker_ext::covreach_ext::options_t::DOT) {
           tchecker::covreach::dot_outputter_t<typename ALGORITHM_MODEL::node_outputter_t>
           dot_outputter(ALGORITHM_MODEL::node_outputter_args(model));
-          dot_outputter.template output<graph_t, tchecker::instrusive_shared_ptr_hash_t>(options.output_stream(),
-                                                                                         graph,
-                                                                                         model.system().name());
+          // The graph is frozen into its compact snapshot, that keeps the nodes alive: the edges and the
+          // buckets of the graph are released before the output, and the nodes once it is done. A graph
+          // with too many nodes for 32 bits ids is output as it is
+          using frozen_graph_t = tchecker_ext::covreach_ext::csr_graph_t<node_ptr_t>;
+          frozen_graph_t frozen;
+          bool is_frozen = true;
+          try {
+            frozen = graph.freeze(options.num_threads());
+          }
+          catch (std::overflow_error const &) {
+            is_frozen = false;
+          }
+          if (is_frozen) {
+            graph.clear(options.num_threads());
+            dot_outputter.template output<frozen_graph_t, tchecker::instrusive_shared_ptr_hash_t>(options.output_stream(),
+                                                                                                  frozen,
+                                                                                                  model.system().name());
+            frozen.clear();
+          }
+          else
+            dot_outputter.template output<graph_t, tchecker::instrusive_shared_ptr_hash_t>(options.output_stream(),
+                                                                                           graph,
+                                                                                           model.system().name());
         }
         
-        gc.stop();
-        graph.clear();
-        graph.free_all();
+        if (options.fast_exit()) {
+          // Nodes are neither destructed nor freed one by one: the process is about to exit
+          std::cout.flush();
+          graph_ptr.release();
+          builder_alloc_ptr.release();
+          return;
+        }
+        free_all();
       }
       
       // todo
@@ -265,7 +485,7 @@ namespace tchecker_ext {
       template
       <class ALGORITHM_MODEL,
       template <class N, class E, class NO, class EO> class GRAPH_OUTPUTTER,
-      template <class NPTR> class WAITING
+      template <class NPTR, class LOCK> class WAITING
       >
       void run_zg(tchecker::parsing::system_declaration_t const & sysdecl,
                   tchecker_ext::covreach_ext::options_t const & options,
@@ -273,6 +493,7 @@ namespace tchecker_ext {
       {
         switch (options.node_covering()) {
           case tchecker::covreach::options_t::INCLUSION:
+            // Also -c federation: nodes not covered by inclusion are checked against federations in the graph
             tchecker_ext::covreach_ext::details::run<tchecker::covreach::cover_inclusion_t, ALGORITHM_MODEL, GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
@@ -302,6 +523,8 @@ namespace tchecker_ext {
        \brief Run covering reachability algorithm
        \tparam GRAPH_OUTPUTTER : type of graph outputter
        \tparam WAITING : type of waiting container
+       \tparam LOCK : type of the locks of the graph and the waiting container
+       \tparam ATOMIC_REFCOUNT : whether the reference counters of the nodes are atomic
        \param sysdecl : a system declaration
        \param log : logging facility
        \param options : covering reachability algorithm options
@@ -310,7 +533,8 @@ namespace tchecker_ext {
        GRAPH_OUPUTTER
        Every error and warning has been reported to log.
        */
-      template <template <class N, class E, class NO, class EO> class GRAPH_OUTPUTTER, template <class NPTR> class WAITING>
+      template <template <class N, class E, class NO, class EO> class GRAPH_OUTPUTTER,
+                template <class NPTR, class LOCK_> class WAITING, class LOCK, bool ATOMIC_REFCOUNT>
       void run(tchecker::parsing::system_declaration_t const & sysdecl,
                tchecker_ext::covreach_ext::options_t const & options,
                tchecker::log_t & log)
@@ -331,109 +555,109 @@ namespace tchecker_ext {
 //            break;
           case tchecker::covreach::options_t::ZG_ELAPSED_NOEXTRA:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_no_extrapolation_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_no_extrapolation_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRAM_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraM_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraM_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRAM_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraM_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraM_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRAM_PLUS_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraMplus_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraMplus_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRAM_PLUS_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraMplus_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraMplus_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRALU_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLU_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLU_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRALU_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLU_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLU_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRALU_PLUS_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLUplus_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLUplus_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_ELAPSED_EXTRALU_PLUS_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLUplus_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::elapsed_extraLUplus_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_NOEXTRA:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_no_extrapolation_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_no_extrapolation_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRAM_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraM_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraM_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRAM_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraM_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraM_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRAM_PLUS_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraMplus_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraMplus_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRAM_PLUS_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraMplus_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraMplus_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRALU_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRALU_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRALU_PLUS_G:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLUplus_global_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLUplus_global_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::ZG_NON_ELAPSED_EXTRALU_PLUS_L:
             tchecker_ext::covreach_ext::details::run_zg
-            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_local_t>,
+            <tchecker_ext::covreach_ext::details::zg::ta::algorithm_model_t<tchecker::zg::ta::non_elapsed_extraLU_local_t, LOCK, ATOMIC_REFCOUNT>,
             GRAPH_OUTPUTTER, WAITING>
             (sysdecl, options, log);
             break;
@@ -449,6 +673,8 @@ namespace tchecker_ext {
       /*!
        \brief Run covering reachability algorithm
        \tparam WAITING : type of waiting container
+       \tparam LOCK : type of the locks of the graph and the waiting container
+       \tparam ATOMIC_REFCOUNT : whether the reference counters of the nodes are atomic
        \param sysdecl : a system declaration
        \param options : covering reachability algorithm options
        \param log : logging facility
@@ -456,23 +682,92 @@ namespace tchecker_ext {
        the exploration policy implemented by WAITING
        Every error and warning has been reported to log.
        */
-      template <template <class NPTR> class WAITING>
+      template <template <class NPTR, class LOCK_> class WAITING, class LOCK, bool ATOMIC_REFCOUNT>
       void run(tchecker::parsing::system_declaration_t const & sysdecl,
                tchecker_ext::covreach_ext::options_t const & options,
                tchecker::log_t & log)
       {
         switch (options.output_format()) {
           case tchecker::covreach::options_t::DOT:
-            tchecker_ext::covreach_ext::details::run<tchecker::graph::dot_outputter_t, WAITING>(sysdecl, options, log);
+            tchecker_ext::covreach_ext::details::run<tchecker::graph::dot_outputter_t, WAITING, LOCK, ATOMIC_REFCOUNT>
+            (sysdecl, options, log);
             break;
           case tchecker::covreach::options_t::RAW:
-            tchecker_ext::covreach_ext::details::run<tchecker::graph::raw_outputter_t, WAITING>(sysdecl, options, log);
+            tchecker_ext::covreach_ext::details::run<tchecker::graph::raw_outputter_t, WAITING, LOCK, ATOMIC_REFCOUNT>
+            (sysdecl, options, log);
             break;
           default:
             log.error("unsupported output format");
         }
       }
       
+      
+      /*!
+       \brief Run covering reachability algorithm
+       \tparam WAITING : type of waiting container
+       \tparam LOCK : type of the locks of the graph and the waiting container
+       \param sysdecl : a system declaration
+       \param options : covering reachability algorithm options
+       \param log : logging facility
+       \post covering reachability algorithm has been run on a model of sysdecl following options and
+       the exploration policy implemented by WAITING, with atomic reference counters on the nodes if
+       options.atomic_refcount()
+       Every error and warning has been reported to log.
+       */
+      template <template <class NPTR, class LOCK_> class WAITING, class LOCK>
+      void run_locked(tchecker::parsing::system_declaration_t const & sysdecl,
+                      tchecker_ext::covreach_ext::options_t const & options,
+                      tchecker::log_t & log)
+      {
+        if (options.atomic_refcount())
+          tchecker_ext::covreach_ext::details::run<WAITING, LOCK, true>(sysdecl, options, log);
+        else
+          tchecker_ext::covreach_ext::details::run<WAITING, LOCK, false>(sysdecl, options, log);
+      }
+      
+      
+      /*!
+       \brief Run covering reachability algorithm
+       \tparam WAITING : type of waiting container
+       \param sysdecl : a system declaration
+       \param options : covering reachability algorithm options
+       \param log : logging facility
+       \post covering reachability algorithm has been run on a model of sysdecl following options and
+       the exploration policy implemented by WAITING
+       Every error and warning has been reported to log.
+       \note single-threaded runs use tchecker_ext::null_lock_t and plain reference counters, hence pay no
+       synchronization. Otherwise the locks are chosen by options.lock_policy()
+       */
+      template <template <class NPTR, class LOCK> class WAITING>
+      void run(tchecker::parsing::system_declaration_t const & sysdecl,
+               tchecker_ext::covreach_ext::options_t const & options,
+               tchecker::log_t & log)
+      {
+        if (options.num_threads() == 1) {
+          tchecker_ext::covreach_ext::details::run<WAITING, tchecker_ext::null_lock_t, false>(sysdecl, options, log);
+          return;
+        }
+        switch (options.lock_policy()) {
+          case tchecker_ext::covreach_ext::options_t::LOCK_TAS:
+            tchecker_ext::covreach_ext::details::run_locked<WAITING, tchecker_ext::spinlock_t>(sysdecl, options, log);
+            break;
+          case tchecker_ext::covreach_ext::options_t::LOCK_TTAS:
+            tchecker_ext::covreach_ext::details::run_locked<WAITING, tchecker_ext::ttas_lock_t>(sysdecl, options, log);
+            break;
+          case tchecker_ext::covreach_ext::options_t::LOCK_TICKET:
+            tchecker_ext::covreach_ext::details::run_locked<WAITING, tchecker_ext::ticket_lock_t>(sysdecl, options, log);
+            break;
+          case tchecker_ext::covreach_ext::options_t::LOCK_MCS:
+            tchecker_ext::covreach_ext::details::run_locked<WAITING, tchecker_ext::mcs_lock_t>(sysdecl, options, log);
+            break;
+          case tchecker_ext::covreach_ext::options_t::LOCK_FUTEX:
+            tchecker_ext::covreach_ext::details::run_locked<WAITING, tchecker_ext::futex_lock_t>(sysdecl, options, log);
+            break;
+          default:
+            log.error("unsupported lock");
+        }
+      }
+      
     } // end of namespace details
     
     
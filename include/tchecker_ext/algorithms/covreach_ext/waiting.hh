@@ -23,10 +23,12 @@ namespace tchecker_ext{
         \brief Waiting container that is thread safe
         \param W : type of underlying waiting container, should contain nodes that inherit
         from tchecker::covreach::node_t.
+        \param LOCK : type of lock, tchecker_ext::null_lock_t for single-threaded runs. In this case
+        the pending counter is not maintained and popping never waits
         \note To be thread safe the container is not allowed to interfere with the reference counter of the underlying objects
               therefore use lists or deque for container, not vector
         */
-      template <class W>
+      template <class W, class LOCK=tchecker_ext::spinlock_t>
       class threaded_waiting_t: private W{
       public:
         /*!
@@ -44,12 +46,12 @@ namespace tchecker_ext{
         /*!
          \brief Copy constructor
          */
-        threaded_waiting_t(tchecker_ext::covreach_ext::details::threaded_waiting_t<W> const &) = delete;
+        threaded_waiting_t(tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> const &) = delete;
     
         /*!
          \brief Move constructor
          */
-        threaded_waiting_t(tchecker_ext::covreach_ext::details::threaded_waiting_t<W> &&) = delete;
+        threaded_waiting_t(tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> &&) = delete;
     
         /*!
          \brief Destructor
@@ -59,14 +61,14 @@ namespace tchecker_ext{
         /*!
          \brief Assignment operator
          */
-        tchecker_ext::covreach_ext::details::threaded_waiting_t<W> &
-        operator= (tchecker_ext::covreach_ext::details::threaded_waiting_t<W> const &) = delete;
+        tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> &
+        operator= (tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> const &) = delete;
     
         /*!
          \brief Move-assignment operator
          */
-        tchecker_ext::covreach_ext::details::threaded_waiting_t<W> &
-        operator= (tchecker_ext::covreach_ext::details::threaded_waiting_t<W> &&) = delete;
+        tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> &
+        operator= (tchecker_ext::covreach_ext::details::threaded_waiting_t<W, LOCK> &&) = delete;
     
         /*!
           \brief Accessor
@@ -76,6 +78,9 @@ namespace tchecker_ext{
           */
         bool empty()
         {
+          if constexpr (!LOCK::concurrent) {
+            return W::empty();
+          }
           _lock.lock();
           bool is_empty = (_n_pending==0) && (W::empty());
           _lock.unlock();
@@ -100,9 +105,11 @@ namespace tchecker_ext{
               assert(node.ptr() == nullptr);
             }
           }
-          if(do_decrement){
-            assert(_n_pending>0);
-            --_n_pending;
+          if constexpr (LOCK::concurrent) {
+            if(do_decrement){
+              assert(_n_pending>0);
+              --_n_pending;
+            }
           }
           // All modifications on waiting done
           
@@ -122,7 +129,26 @@ namespace tchecker_ext{
          \note This call is blocking
          */
         bool pop_and_increment(node_ptr_t & node){
+          return pop_and_increment(node, [] () {});
+        }
+        
+        /*!
+         \brief Same as above
+         \param node : reference to a node pointer
+         \param idle : called while the container is empty but other workers may still insert elements
+         \note idle is called without holding the lock of the container
+         */
+        template <class IDLE>
+        bool pop_and_increment(node_ptr_t & node, IDLE && idle){
           assert(node.ptr()==nullptr);
+          if constexpr (!LOCK::concurrent) {
+            // No other thread can enqueue nodes
+            if (W::empty()){
+              return false;
+            }
+            W::swap_first_and_remove(node);
+            return true;
+          }
           while(true){ // Redo loop until container is empty
             _lock.lock();//blocking until locked
 
@@ -141,6 +167,7 @@ namespace tchecker_ext{
 
             _lock.unlock(); //Sleep how long?
             // If one arrives here that means that other workers might enqueue node -> redo the loop
+            idle();
             std::this_thread::sleep_for(std::chrono::microseconds(5));//todo
           } // while
         }
@@ -152,7 +179,7 @@ namespace tchecker_ext{
         }
   
       private:
-        tchecker_ext::spinlock_t _lock; /*! Lock making the waiting list thread safe */
+        LOCK _lock; /*! Lock making the waiting list thread safe */
         long _n_pending=0; /*! Number of threads that are still pending, that is, which are likely to enqueue elements */
       };
       
@@ -163,15 +190,15 @@ namespace tchecker_ext{
      \brief First-In-First-Out waiting container
      \note this container does not filter active nodes - this is currently not supported by threading
      */
-    template <class NODE_PTR>
-    using threaded_fifo_waiting_t = tchecker_ext::covreach_ext::details::threaded_waiting_t<tchecker::fifo_waiting_t<NODE_PTR>>;
+    template <class NODE_PTR, class LOCK=tchecker_ext::spinlock_t>
+    using threaded_fifo_waiting_t = tchecker_ext::covreach_ext::details::threaded_waiting_t<tchecker::fifo_waiting_t<NODE_PTR>, LOCK>;
     
     /*!
      \brief Last-In-First-Out waiting container
      \note this container does not filter active nodes - this is currently not supported by threading
      */
-    template <class NODE_PTR>
-    using threaded_lifo_waiting_t = tchecker_ext::covreach_ext::details::threaded_waiting_t<tchecker::lifo_waiting_t<NODE_PTR>>;
+    template <class NODE_PTR, class LOCK=tchecker_ext::spinlock_t>
+    using threaded_lifo_waiting_t = tchecker_ext::covreach_ext::details::threaded_waiting_t<tchecker::lifo_waiting_t<NODE_PTR>, LOCK>;
     
   } // covreach_ext
 } // tchecker_ext
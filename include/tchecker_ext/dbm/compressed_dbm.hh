@@ -0,0 +1,406 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_COMPRESSED_DBM_HH
+#define TCHECKER_EXT_COMPRESSED_DBM_HH
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/db16.hh"
+#include "tchecker_ext/dbm/simd.hh"
+
+/*!
+ \file compressed_dbm.hh
+ \brief DBMs stored as their minimal set of constraints, or as dense DBMs on 16 bits
+ */
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+    /*!
+     \class constraint_t
+     \brief Difference constraint x_i - x_j # c, with # and c encoded in db
+     */
+    struct constraint_t {
+      std::uint16_t i;          /*!< First clock */
+      std::uint16_t j;          /*!< Second clock */
+      tchecker::dbm::db_t db;   /*!< Difference bound */
+    };
+
+    /*!
+     \class constraint16_t
+     \brief Difference constraint x_i - x_j # c on at most 256 clocks, with # and c encoded on 16 bits in db
+     \note half the size of constraint_t, used when the zone has small dimension and small constants
+     */
+    struct constraint16_t {
+      std::uint8_t i;                         /*!< First clock */
+      std::uint8_t j;                         /*!< Second clock */
+      tchecker_ext::dbm_ext::db16_t db;       /*!< Difference bound */
+    };
+
+    /*!
+     \brief Check if the constraints of a dbm can be stored as constraint16_t
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     \return true if dim <= 256 and all bounds of dbm fit on 16 bits, false otherwise
+     */
+    bool fits_constraint16(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Minimal set of constraints
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \param constraints : array of at least dim*dim constraints
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     dbm is consistent (checked by assertion)
+     dbm is tight (checked by assertion)
+     1 <= dim <= 65536 (checked by assertion)
+     \post constraints starts with a minimal set of constraints whose tightening is dbm.
+     Clocks whose differences are fixed (zero cycles) form classes: the constraints of a class are a
+     cycle through its clocks, and the constraints between classes are only kept between the smallest
+     clocks of the classes, if they are not implied by a path through a third class
+     (K. G. Larsen, F. Larsson, P. Pettersson, W. Yi, "Efficient verification of real-time systems:
+     compact data structure and state-space reduction", RTSS 1997)
+     \return number of constraints in the minimal set
+     */
+    std::size_t minimal_constraints(tchecker::dbm::db_t const * dbm,
+                                    tchecker::clock_id_t dim,
+                                    tchecker_ext::dbm_ext::constraint_t * constraints);
+
+    /*!
+     \brief Minimal set of constraints on 16 bits
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \param constraints : array of at least dim*dim constraints
+     \pre see minimal_constraints() above, and fits_constraint16(dbm, dim) (checked by assertion)
+     \post see minimal_constraints() above
+     \return number of constraints in the minimal set
+     */
+    std::size_t minimal_constraints(tchecker::dbm::db_t const * dbm,
+                                    tchecker::clock_id_t dim,
+                                    tchecker_ext::dbm_ext::constraint16_t * constraints);
+
+    /*!
+     \brief Expansion of a set of constraints
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \param constraints : array of constraints
+     \param n : number of constraints
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     constraints is a minimal set of constraints on clocks < dim, as computed by minimal_constraints()
+     \post dbm is the tight dbm of the constraints
+     */
+    void expand_constraints(tchecker::dbm::db_t * dbm,
+                            tchecker::clock_id_t dim,
+                            tchecker_ext::dbm_ext::constraint_t const * constraints,
+                            std::size_t n);
+
+    /*!
+     \brief Expansion of a set of constraints on 16 bits
+     \note see expand_constraints() above
+     */
+    void expand_constraints(tchecker::dbm::db_t * dbm,
+                            tchecker::clock_id_t dim,
+                            tchecker_ext::dbm_ext::constraint16_t const * constraints,
+                            std::size_t n);
+
+    /*!
+     \brief Inclusion in a set of constraints
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \param constraints : array of constraints
+     \param n : number of constraints
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     dbm is tight (checked by assertion)
+     constraints are constraints on clocks < dim
+     \return true if the zone of dbm satisfies all constraints, false otherwise
+     \note as dbm is tight, this decides the inclusion of dbm in the zone of constraints without expanding it
+     */
+    bool is_le(tchecker::dbm::db_t const * dbm,
+               tchecker::clock_id_t dim,
+               tchecker_ext::dbm_ext::constraint_t const * constraints,
+               std::size_t n);
+
+    /*!
+     \brief Inclusion in a set of constraints on 16 bits
+     \note see is_le() above
+     */
+    bool is_le(tchecker::dbm::db_t const * dbm,
+               tchecker::clock_id_t dim,
+               tchecker_ext::dbm_ext::constraint16_t const * constraints,
+               std::size_t n);
+
+    /*!
+     \brief Fast rejection of the inclusion of a set of constraints in a dbm
+     \param constraints : array of constraints
+     \param n : number of constraints
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     constraints is a minimal set of constraints as computed by minimal_constraints()
+     \return false if the zone of constraints is not included in the zone of dbm, true if it may be included
+     \note the minimal constraints are entries of the tight dbm they stem from, hence a minimal constraint
+     weaker than the corresponding entry of dbm disproves the inclusion
+     */
+    bool may_be_le(tchecker_ext::dbm_ext::constraint_t const * constraints,
+                   std::size_t n,
+                   tchecker::dbm::db_t const * dbm,
+                   tchecker::clock_id_t dim);
+
+    /*!
+     \brief Fast rejection of the inclusion of a set of constraints on 16 bits in a dbm
+     \note see may_be_le() above
+     */
+    bool may_be_le(tchecker_ext::dbm_ext::constraint16_t const * constraints,
+                   std::size_t n,
+                   tchecker::dbm::db_t const * dbm,
+                   tchecker::clock_id_t dim);
+
+
+    /*!
+     \class compressed_dbm_t
+     \brief Tight DBM stored as its minimal set of constraints, or as a dense DBM on 16 bits
+     \note constraints are stored on 16 bits (constraint16_t) when the dimension and the bounds of the DBM
+     allow it, which is the case for all zones of models with small maximal constants after extrapolation,
+     and on 32 bits (constraint_t) otherwise
+     \note when the bounds fit on 16 bits and the dense DBM on 16 bits is smaller than the minimal
+     constraints (zones with many non-redundant constraints), the record stores the dense DBM instead: half
+     the size of the tchecker DBM, and inclusion is decided by the 16 bits kernels of simd.hh
+     \note a compressed DBM is a single record: an 8 bytes header immediately followed by its constraints.
+     Records are built by make() in memory provided by the caller (typically an arena), and are never
+     destructed: they are trivially destructible, and released with their memory
+     */
+    class compressed_dbm_t {
+    public:
+      /*!
+       \brief Builder
+       \param dbm : a dbm
+       \param dim : dimension of dbm
+       \param allocate : callable such that allocate(bytes, align) returns bytes uninitialized bytes aligned
+       on align
+       \pre see minimal_constraints()
+       \return a record with the minimal constraints of dbm, on 16 bits if fits_constraint16(dbm, dim), or
+       with the dense DBM dbm on 16 bits if it fits and is smaller, in memory returned by allocate (called once)
+       \note the constraints are computed before allocate is called
+       */
+      template <class ALLOCATE>
+      static tchecker_ext::dbm_ext::compressed_dbm_t const *
+      make(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim, ALLOCATE && allocate)
+      {
+        bool const fits16 = tchecker_ext::dbm_ext::fits_db16(dbm, dim);
+        bool const db16 = fits16 && (dim <= 256);
+        void const * constraints = nullptr;
+        std::size_t const n = minimal_constraints_scratch(dbm, dim, db16, constraints);
+        std::size_t const dense_size = static_cast<std::size_t>(dim) * dim;
+        bool const dense = fits16 && (record_bytes(dense_size, true, true) < record_bytes(n, db16, false));
+        std::size_t const size = (dense ? dense_size : n);
+        std::size_t const bytes = record_bytes(size, db16 || dense, dense);
+        void * p = allocate(bytes, alignof(tchecker_ext::dbm_ext::compressed_dbm_t));
+        tchecker_ext::dbm_ext::compressed_dbm_t * c =
+            new (p) tchecker_ext::dbm_ext::compressed_dbm_t(dim, size, db16 || dense, dense);
+        if (dense)
+          tchecker_ext::dbm_ext::to_db16(reinterpret_cast<tchecker_ext::dbm_ext::db16_t *>(c + 1), dbm, dim);
+        else
+          std::memcpy(static_cast<void *>(c + 1), constraints, bytes - sizeof(tchecker_ext::dbm_ext::compressed_dbm_t));
+        return c;
+      }
+
+      compressed_dbm_t(tchecker_ext::dbm_ext::compressed_dbm_t const &) = delete;
+      compressed_dbm_t(tchecker_ext::dbm_ext::compressed_dbm_t &&) = delete;
+      ~compressed_dbm_t() = default;
+      tchecker_ext::dbm_ext::compressed_dbm_t & operator= (tchecker_ext::dbm_ext::compressed_dbm_t const &) = delete;
+      tchecker_ext::dbm_ext::compressed_dbm_t & operator= (tchecker_ext::dbm_ext::compressed_dbm_t &&) = delete;
+
+      /*!
+       \brief Accessor
+       \return dimension of the dbm
+       */
+      inline tchecker::clock_id_t dim() const
+      {
+        return _dim;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of constraints, or number of bounds (dim() * dim()) if this is dense
+       */
+      inline std::size_t size() const
+      {
+        return _size;
+      }
+
+      /*!
+       \brief Accessor
+       \return memory used by the record, header included (bytes)
+       */
+      inline std::size_t bytes() const
+      {
+        return record_bytes(_size, is_db16(), is_dense());
+      }
+
+      /*!
+       \brief Accessor
+       \return true if bounds are stored on 16 bits, false otherwise
+       */
+      inline bool is_db16() const
+      {
+        return (_db16 != 0);
+      }
+
+      /*!
+       \brief Accessor
+       \return true if this stores a dense DBM on 16 bits, false if it stores constraints
+       */
+      inline bool is_dense() const
+      {
+        return (_dense != 0);
+      }
+
+      /*!
+       \brief Expansion
+       \param dbm : a dim()*dim() array of difference bounds
+       \post dbm is the tight dbm this has been built from
+       */
+      inline void expand(tchecker::dbm::db_t * dbm) const
+      {
+        if (is_dense())
+          tchecker_ext::dbm_ext::to_db(dbm, dense16(), _dim);
+        else if (is_db16())
+          tchecker_ext::dbm_ext::expand_constraints(dbm, _dim, constraints16(), _size);
+        else
+          tchecker_ext::dbm_ext::expand_constraints(dbm, _dim, constraints(), _size);
+      }
+
+      /*!
+       \brief Inclusion
+       \param dbm : a tight dim()*dim() dbm
+       \return true if the zone of dbm is included in the zone of this, false otherwise
+       */
+      inline bool is_ge(tchecker::dbm::db_t const * dbm) const
+      {
+        if (is_dense())
+          return tchecker_ext::dbm_ext::is_le(dbm, dense16(), _dim);
+        if (is_db16())
+          return tchecker_ext::dbm_ext::is_le(dbm, _dim, constraints16(), _size);
+        return tchecker_ext::dbm_ext::is_le(dbm, _dim, constraints(), _size);
+      }
+
+      /*!
+       \brief Fast rejection of inclusion
+       \param dbm : a dim()*dim() dbm
+       \return false if the zone of this is not included in the zone of dbm, true if it may be included
+       \note exact if this is dense: true iff the zone of this is included in the zone of dbm
+       */
+      inline bool may_be_le(tchecker::dbm::db_t const * dbm) const
+      {
+        if (is_dense())
+          return tchecker_ext::dbm_ext::is_le(dense16(), dbm, _dim);
+        if (is_db16())
+          return tchecker_ext::dbm_ext::may_be_le(constraints16(), _size, dbm, _dim);
+        return tchecker_ext::dbm_ext::may_be_le(constraints(), _size, dbm, _dim);
+      }
+
+    private:
+      /*!
+       \brief Constructor
+       \param dim : dimension of the dbm
+       \param size : number of constraints, or dim * dim if dense
+       \param db16 : whether bounds are stored on 16 bits
+       \param dense : whether the record stores a dense DBM
+       \pre db16 if dense, size < 2^30 (checked by assertion)
+       \post the header of a record of size constraints or bounds. They are stored by make()
+       */
+      compressed_dbm_t(tchecker::clock_id_t dim, std::size_t size, bool db16, bool dense)
+      : _dim(static_cast<std::uint32_t>(dim)), _size(static_cast<std::uint32_t>(size)), _db16(db16 ? 1 : 0),
+      _dense(dense ? 1 : 0)
+      {
+        assert(db16 || !dense);
+        assert(size < (std::size_t(1) << 30));
+      }
+
+      /*!
+       \brief Minimal constraints in a per-thread scratch buffer
+       \param dbm : a dbm
+       \param dim : dimension of dbm
+       \param db16 : whether constraints are computed on 16 bits
+       \param constraints : pointer to constraints
+       \pre see minimal_constraints(), and fits_constraint16(dbm, dim) if db16
+       \post constraints points to the minimal constraints of dbm (constraint16_t if db16, constraint_t
+       otherwise) in a per-thread buffer, valid until the next call by the same thread
+       \return number of constraints
+       */
+      static std::size_t minimal_constraints_scratch(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim,
+                                                     bool db16, void const * & constraints);
+
+      /*!
+       \brief Size of a record
+       \param size : number of constraints, or of bounds if dense
+       \param db16 : whether bounds are stored on 16 bits
+       \param dense : whether the record stores a dense DBM
+       \return number of bytes of a record of size constraints or bounds
+       */
+      static inline std::size_t record_bytes(std::size_t size, bool db16, bool dense)
+      {
+        std::size_t const entry = (dense ? sizeof(tchecker_ext::dbm_ext::db16_t) :
+                                   (db16 ? sizeof(tchecker_ext::dbm_ext::constraint16_t) :
+                                    sizeof(tchecker_ext::dbm_ext::constraint_t)));
+        return sizeof(tchecker_ext::dbm_ext::compressed_dbm_t) + size * entry;
+      }
+
+      /*!
+       \brief Accessor
+       \return constraints of this (32 bits), that follow the header
+       */
+      inline tchecker_ext::dbm_ext::constraint_t const * constraints() const
+      {
+        return reinterpret_cast<tchecker_ext::dbm_ext::constraint_t const *>(this + 1);
+      }
+
+      /*!
+       \brief Accessor
+       \return constraints of this (16 bits), that follow the header
+       */
+      inline tchecker_ext::dbm_ext::constraint16_t const * constraints16() const
+      {
+        return reinterpret_cast<tchecker_ext::dbm_ext::constraint16_t const *>(this + 1);
+      }
+
+      /*!
+       \brief Accessor
+       \return dense DBM of this (16 bits), that follows the header
+       */
+      inline tchecker_ext::dbm_ext::db16_t const * dense16() const
+      {
+        return reinterpret_cast<tchecker_ext::dbm_ext::db16_t const *>(this + 1);
+      }
+
+      std::uint32_t _dim; /*!< Dimension of the dbm */
+      std::uint32_t _size : 30; /*!< Number of constraints, or of bounds if dense */
+      std::uint32_t _db16 : 1; /*!< Whether bounds are stored on 16 bits */
+      std::uint32_t _dense : 1; /*!< Whether the record stores a dense DBM */
+    };
+
+    static_assert(sizeof(tchecker_ext::dbm_ext::compressed_dbm_t) == 8, "header of compressed dbms is 8 bytes");
+    static_assert(sizeof(tchecker_ext::dbm_ext::compressed_dbm_t) % alignof(tchecker_ext::dbm_ext::constraint_t) == 0,
+                  "constraints are aligned after the header");
+
+  }
+}
+
+#endif //TCHECKER_EXT_COMPRESSED_DBM_HH
@@ -0,0 +1,124 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_DB16_HH
+#define TCHECKER_EXT_DB16_HH
+
+#include <cstdint>
+#include <limits>
+
+#include "tchecker/dbm/dbm.hh"
+
+/*!
+ \file db16.hh
+ \brief Difference bounds encoded on 16 bits
+ \note The encoding is the one of tchecker::dbm::db_t, (value << 1) | comparator, on 16 bits. It preserves
+ the order of bounds: two 16 bits bounds compare as the 32 bits bounds they encode. 16 bits bounds are
+ used by the records of compressed zones, as constraints or as dense DBMs (see compressed_dbm.hh)
+ */
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+    /*!
+     \brief Type of 16 bits difference bounds
+     */
+    using db16_t = std::int16_t;
+
+    /*!
+     \brief Encoding of < infinity on 16 bits
+     */
+    constexpr tchecker_ext::dbm_ext::db16_t LT_INFINITY16 = std::numeric_limits<db16_t>::max() - 1;
+
+    /*!
+     \brief Smallest finite bound encoded on 16 bits
+     */
+    constexpr tchecker_ext::dbm_ext::db16_t DB16_MIN = - LT_INFINITY16;
+
+    /*!
+     \brief Largest finite bound encoded on 16 bits
+     \note LT_INFINITY16 - 1 is never stored: the kernels of simd.hh read the 32 bits bounds above DB16_MAX
+     as LT_INFINITY16 - 1, between all finite 16 bits bounds and infinity
+     */
+    constexpr tchecker_ext::dbm_ext::db16_t DB16_MAX = LT_INFINITY16 - 2;
+
+    /*!
+     \brief Check if a bound can be encoded on 16 bits
+     \param db : difference bound
+     \return true if db is < infinity or a finite bound within [DB16_MIN, DB16_MAX], false otherwise
+     */
+    inline bool fits_db16(tchecker::dbm::db_t db)
+    {
+      return (db == tchecker::dbm::LT_INFINITY) || ((db >= DB16_MIN) && (db <= DB16_MAX));
+    }
+
+    /*!
+     \brief Encoding on 16 bits
+     \param db : difference bound
+     \pre fits_db16(db)
+     \return db encoded on 16 bits
+     */
+    inline tchecker_ext::dbm_ext::db16_t to_db16(tchecker::dbm::db_t db)
+    {
+      return (db == tchecker::dbm::LT_INFINITY ? LT_INFINITY16 : static_cast<db16_t>(db));
+    }
+
+    /*!
+     \brief Decoding from 16 bits
+     \param db : 16 bits difference bound
+     \return db as a tchecker::dbm::db_t
+     */
+    inline tchecker::dbm::db_t to_db(tchecker_ext::dbm_ext::db16_t db)
+    {
+      return (db == LT_INFINITY16 ? tchecker::dbm::LT_INFINITY : static_cast<tchecker::dbm::db_t>(db));
+    }
+
+    /*!
+     \brief Identity on 32 bits bounds
+     \param db : difference bound
+     \return db
+     */
+    inline tchecker::dbm::db_t to_db(tchecker::dbm::db_t db)
+    {
+      return db;
+    }
+
+    /*!
+     \brief Check if the bounds of a dbm can be encoded on 16 bits
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds
+     \return true if all bounds of dbm fit on 16 bits, false otherwise
+     */
+    bool fits_db16(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Encoding of a dbm on 16 bits
+     \param dbm16 : a dim*dim array of 16 bits difference bounds
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \pre dbm and dbm16 are not nullptr (checked by assertion)
+     fits_db16(dbm, dim) (checked by assertion)
+     \post dbm16 is dbm encoded on 16 bits
+     */
+    void to_db16(tchecker_ext::dbm_ext::db16_t * dbm16, tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Decoding of a dbm from 16 bits
+     \param dbm : a dim*dim array of difference bounds
+     \param dbm16 : a 16 bits dbm
+     \param dim : dimension of dbm16
+     \pre dbm and dbm16 are not nullptr (checked by assertion)
+     \post dbm is dbm16 decoded on 32 bits
+     */
+    void to_db(tchecker::dbm::db_t * dbm, tchecker_ext::dbm_ext::db16_t const * dbm16, tchecker::clock_id_t dim);
+
+  }
+}
+
+#endif //TCHECKER_EXT_DB16_HH
@@ -5,6 +5,9 @@
 #ifndef TCHECKER_EXT_DBM_HH
 #define TCHECKER_EXT_DBM_HH
 
+#include <cstddef>
+#include <vector>
+
 #include "tchecker/dbm/dbm.hh"
 
 namespace tchecker_ext{
@@ -27,6 +30,8 @@ namespace tchecker_ext{
      dbm is tight
      \return EMPTY if the intersection of dbm1 and dbm2 is empty, NON_EMPTY otherwise
      \note dbm can be one of dbm1 or dbm2
+     \note vectorized (see tchecker_ext/dbm/simd.hh): the entries of dbm2 are gathered through idx_clk
+     and dbm is tightened by the vectorized Floyd-Warshall. Same result as partial_intersection_scalar()
      */
     enum tchecker::dbm::status_t partial_intersection(tchecker::dbm::db_t * dbm,
                                               tchecker::dbm::db_t const * dbm1,
@@ -35,6 +40,68 @@ namespace tchecker_ext{
                                               tchecker::clock_id_t dim2,
                                               tchecker::clock_id_t const * idx_clk);
     
+    /*!
+     \brief Partial Intersection, scalar version
+     \note see partial_intersection()
+     */
+    enum tchecker::dbm::status_t partial_intersection_scalar(tchecker::dbm::db_t * dbm,
+                                                     tchecker::dbm::db_t const * dbm1,
+                                                     tchecker::dbm::db_t const * dbm2,
+                                                     tchecker::clock_id_t dim1,
+                                                     tchecker::clock_id_t dim2,
+                                                     tchecker::clock_id_t const * idx_clk);
+    
+    /*!
+     \brief Exact convex union
+     \param hull : a dim*dim array of difference bounds
+     \param scratch : a dim*dim array of difference bounds
+     \param dbm1 : a dbm
+     \param dbm2 : a dbm
+     \param dim : dimension of dbm1 and dbm2
+     \pre hull, scratch, dbm1 and dbm2 are not nullptr (checked by assertion)
+     dbm1 and dbm2 are consistent (checked by assertion)
+     dbm1 and dbm2 are tight (checked by assertion)
+     dim >= 1 (checked by assertion).
+     \post hull is the convex hull of dbm1 and dbm2 (tight). scratch has been overwritten
+     \return true if the zone of hull is the union of the zones of dbm1 and dbm2, false otherwise
+     \note hull minus dbm1 is the union, over the constraints of dbm1 that are not satisfied by hull, of hull
+     intersected with the negation of the constraint. These pieces do not meet dbm1, hence the union is exact
+     iff every non-empty piece is included in dbm2. Each piece is built in scratch
+     */
+    bool exact_convex_union(tchecker::dbm::db_t * hull,
+                            tchecker::dbm::db_t * scratch,
+                            tchecker::dbm::db_t const * dbm1,
+                            tchecker::dbm::db_t const * dbm2,
+                            tchecker::clock_id_t dim);
+    
+    /*!
+     \brief Inclusion in a union of zones
+     \param dbm : a dbm
+     \param dbms : array of n dbms
+     \param n : number of dbms in dbms
+     \param dim : dimension of dbm and of the dbms in dbms
+     \param pieces : scratch vector
+     \param next : scratch vector
+     \param max_pieces : bound on the number of pieces
+     \pre dbm and the dbms in dbms are not nullptr (checked by assertion)
+     dbm and the dbms in dbms are consistent (checked by assertion)
+     dbm and the dbms in dbms are tight (checked by assertion)
+     dim >= 1 (checked by assertion).
+     \post pieces and next have been overwritten
+     \return true if the zone of dbm is included in the union of the zones of dbms, false if it is not, or if
+     the difference of dbm and the first dbms has more than max_pieces pieces
+     \note dbm minus the dbms is computed as a list of disjoint tight pieces. A piece P minus a dbm Z is P if
+     they do not meet, and otherwise the union, over the constraints c of Z not satisfied by P, of P intersected
+     with the constraints before c and with the negation of c
+     */
+    bool is_le_union(tchecker::dbm::db_t const * dbm,
+                     tchecker::dbm::db_t const * const * dbms,
+                     std::size_t n,
+                     tchecker::clock_id_t dim,
+                     std::vector<tchecker::dbm::db_t> & pieces,
+                     std::vector<tchecker::dbm::db_t> & next,
+                     std::size_t max_pieces);
+    
   }
 }
 
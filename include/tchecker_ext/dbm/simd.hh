@@ -0,0 +1,201 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_DBM_SIMD_HH
+#define TCHECKER_EXT_DBM_SIMD_HH
+
+#include "tchecker/basictypes.hh"
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/db16.hh"
+
+/*!
+ \file simd.hh
+ \brief Vectorized kernels on dbms (AVX2, SSE4.1, scalar fallback), selected by runtime CPU detection
+ \note Bounds are compared as signed 32 bits integers: the encoding of tchecker::dbm::db_t,
+ (value << 1) | comparator, preserves the order of bounds. The kernels stop on the first vector with
+ a violating entry
+ \note The inclusion kernels on 16 bits dbms narrow the 32 bits bounds with signed saturation, and compare
+ 16 bits lanes: twice as many bounds per vector as on 32 bits
+ */
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+    /*!
+     \brief Instruction sets of the kernels
+     */
+    enum simd_level_t {
+      SIMD_SCALAR,   /*!< Scalar kernels */
+      SIMD_SSE4,     /*!< 128 bits kernels (SSE4.1) */
+      SIMD_AVX2,     /*!< 256 bits kernels (AVX2) */
+    };
+
+    /*!
+     \brief Accessor
+     \return instruction set of the kernels selected for the running CPU
+     \note the CPU is checked once, the first time a kernel is selected
+     */
+    enum tchecker_ext::dbm_ext::simd_level_t simd_level();
+
+    /*!
+     \brief Name of an instruction set
+     \param level : instruction set
+     \return name of level
+     */
+    char const * simd_level_name(enum tchecker_ext::dbm_ext::simd_level_t level);
+
+    /*!
+     \brief Inclusion
+     \param dbm1 : a dbm
+     \param dbm2 : a dbm
+     \param dim : dimension of dbm1 and dbm2
+     \pre dbm1 and dbm2 are not nullptr (checked by assertion)
+     dbm1 and dbm2 are tight
+     \return true if the zone of dbm1 is included in the zone of dbm2, false otherwise
+     \note same result as tchecker::dbm::is_le(), with the kernel of simd_level()
+     */
+    bool is_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Inclusion in a 16 bits dbm
+     \param dbm1 : a dbm
+     \param dbm2 : a 16 bits dbm
+     \param dim : dimension of dbm1 and dbm2
+     \pre dbm1 and dbm2 are not nullptr (checked by assertion)
+     dbm1 and dbm2 are tight
+     \return true if the zone of dbm1 is included in the zone of dbm2, false otherwise
+     \note same result as is_le() on dbm2 decoded on 32 bits. The bounds of dbm1 are encoded on 16 bits
+     in registers: infinity as LT_INFINITY16, finite bounds saturated to [-32768, LT_INFINITY16 - 1], which
+     preserves their order w.r.t. all bounds within fits_db16()
+     */
+    bool is_le(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Inclusion of a 16 bits dbm
+     \param dbm1 : a 16 bits dbm
+     \param dbm2 : a dbm
+     \param dim : dimension of dbm1 and dbm2
+     \pre see is_le() above
+     \return true if the zone of dbm1 is included in the zone of dbm2, false otherwise
+     \note see is_le() above
+     */
+    bool is_le(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Inclusion in the aLU abstraction
+     \param dbm1 : a dbm
+     \param dbm2 : a dbm
+     \param dim : dimension of dbm1 and dbm2
+     \param l : clock lower bounds, l[0] = 0
+     \param u : clock upper bounds, u[0] = 0
+     \pre dbm1, dbm2, l and u are not nullptr (checked by assertion)
+     dbm1 and dbm2 are consistent and tight. Negative bounds stand for clocks without bound
+     \return true if the zone of dbm1 is included in aLU(dbm2), false otherwise
+     \note dbm[i,j] bounds x_i - x_j. The zone of dbm1 is not included in aLU(dbm2) iff there are clocks
+     x and y such that dbm1[0,x] >= (<=,-U_x), dbm2[y,x] < dbm1[y,x] and dbm2[y,x] + (<,-L_y) < dbm1[0,x]
+     (Herbreteau, Srivathsan and Walukiewicz, Better abstractions for timed automata). The kernel goes
+     through rows y, and compares them with row 0 of dbm1 and the bounds U in vector-width chunks of
+     columns x
+     \note same result as tchecker::dbm::is_alu_le()
+     */
+    bool is_alu_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                   tchecker::integer_t const * l, tchecker::integer_t const * u);
+
+    /*!
+     \brief Inclusion in the aM abstraction
+     \param dbm1 : a dbm
+     \param dbm2 : a dbm
+     \param dim : dimension of dbm1 and dbm2
+     \param m : clock bounds, m[0] = 0
+     \pre see is_alu_le()
+     \return true if the zone of dbm1 is included in aM(dbm2), false otherwise
+     \note aM is aLU with L = U = M. Same result as tchecker::dbm::is_am_le()
+     */
+    bool is_am_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                  tchecker::integer_t const * m);
+
+    /*!
+     \brief Tightening
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \pre dbm is not nullptr (checked by assertion)
+     dbm is a dim*dim array of difference bounds, its diagonal is (<=,0)
+     \post same as tchecker::dbm::tighten(): dbm is tight if it is not empty, otherwise dbm(0,0) is (<,0)
+     \return same as tchecker::dbm::tighten()
+     \throw same as tchecker::dbm::tighten() if a sum of finite bounds overflows
+     \note the vector kernels do not check their sums. They are only used when 2 * dim times the largest
+     absolute value of a finite bound is below tchecker::dbm::INF_VALUE, so that no sum overflows (checked
+     in one pass over dbm). Otherwise dbm is tightened by tchecker::dbm::tighten(), that checks every sum
+     \note Floyd-Warshall: for each k, the rows i are updated in vector-width chunks of columns from the
+     broadcast dbm(i,k) and row k. Rows are checked for emptiness in the same order as tchecker, hence dbm
+     is the same when it is found empty
+     */
+    enum tchecker::dbm::status_t tighten(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Partial entry-wise minimum
+     \param dbm : a dim1*dim1 array of difference bounds
+     \param dbm1 : a dbm of dimension dim1
+     \param dbm2 : a dbm of dimension dim2
+     \param dim1 : dimension of dbm and dbm1
+     \param dim2 : dimension of dbm2
+     \param idx_clk : array of dim1 clock indices in dbm2
+     \pre dbm, dbm1, dbm2 and idx_clk are not nullptr (checked by assertion)
+     dim2 >= dim1 >= 1 (checked by assertion). dbm is dbm1 or does not meet dbm1 and dbm2
+     \post dbm(i,j) is the minimum of dbm1(i,j) and dbm2(idx_clk[i],idx_clk[j]) for all i, j
+     \note the entries of a row of dbm2 are gathered through idx_clk
+     */
+    void partial_min(tchecker::dbm::db_t * dbm,
+                     tchecker::dbm::db_t const * dbm1,
+                     tchecker::dbm::db_t const * dbm2,
+                     tchecker::clock_id_t dim1,
+                     tchecker::clock_id_t dim2,
+                     tchecker::clock_id_t const * idx_clk);
+
+    /*!
+     \brief Scalar kernel of is_le()
+     */
+    bool is_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Scalar kernel of is_le() in a 16 bits dbm
+     */
+    bool is_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2,
+                      tchecker::clock_id_t dim);
+
+    /*!
+     \brief Scalar kernel of is_le() of a 16 bits dbm
+     */
+    bool is_le_scalar(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2,
+                      tchecker::clock_id_t dim);
+
+    /*!
+     \brief Scalar kernel of is_alu_le()
+     */
+    bool is_alu_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                          tchecker::integer_t const * l, tchecker::integer_t const * u);
+
+    /*!
+     \brief Scalar kernel of tighten()
+     */
+    enum tchecker::dbm::status_t tighten_scalar(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim);
+
+    /*!
+     \brief Scalar kernel of partial_min()
+     */
+    void partial_min_scalar(tchecker::dbm::db_t * dbm,
+                            tchecker::dbm::db_t const * dbm1,
+                            tchecker::dbm::db_t const * dbm2,
+                            tchecker::clock_id_t dim1,
+                            tchecker::clock_id_t dim2,
+                            tchecker::clock_id_t const * idx_clk);
+
+  }
+}
+
+#endif //TCHECKER_EXT_DBM_SIMD_HH
@@ -0,0 +1,156 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_LOCK_STRIPES_HH
+#define TCHECKER_EXT_LOCK_STRIPES_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/*!
+ \file lock_stripes.hh
+ \brief Array of cache-line padded locks shared by the buckets of a table
+ */
+
+namespace tchecker_ext {
+
+  /*!
+   \brief Size of a cache line (bytes)
+   */
+  constexpr std::size_t cache_line_size = 64;
+
+  /*!
+   \class cache_aligned_t
+   \brief Object alone on its own cache line(s)
+   \tparam T : type of object
+   */
+  template <class T>
+  struct alignas(tchecker_ext::cache_line_size) cache_aligned_t {
+    T value;
+  };
+
+  /*!
+   \class lock_stripes_t
+   \brief Fixed number of locks (stripes) protecting an arbitrary number of buckets
+   \tparam LOCK : type of lock
+   \note Bucket b is protected by stripe b % size(). Every stripe is on its own cache line,
+   so that locking two different stripes never causes false sharing
+   */
+  template <class LOCK>
+  class lock_stripes_t {
+  public:
+    /*!
+     \brief Constructor
+     \param n_stripes : number of stripes
+     \pre n_stripes > 0 (checked by assertion)
+     \post this has n_stripes unlocked stripes
+     */
+    explicit lock_stripes_t(std::size_t n_stripes=1)
+    : _n_stripes(n_stripes),
+      _stripes(new tchecker_ext::cache_aligned_t<LOCK>[n_stripes])
+    {
+      assert(n_stripes > 0);
+    }
+
+    /*!
+     \brief Copy constructor (deleted)
+     */
+    lock_stripes_t(tchecker_ext::lock_stripes_t<LOCK> const &) = delete;
+
+    /*!
+     \brief Move constructor
+     */
+    lock_stripes_t(tchecker_ext::lock_stripes_t<LOCK> &&) = default;
+
+    /*!
+     \brief Destructor
+     */
+    ~lock_stripes_t() = default;
+
+    /*!
+     \brief Assignment operator (deleted)
+     */
+    tchecker_ext::lock_stripes_t<LOCK> & operator= (tchecker_ext::lock_stripes_t<LOCK> const &) = delete;
+
+    /*!
+     \brief Move-assignment operator
+     \pre no lock of this is taken
+     */
+    tchecker_ext::lock_stripes_t<LOCK> & operator= (tchecker_ext::lock_stripes_t<LOCK> &&) = default;
+
+    /*!
+     \brief Accessor
+     \return number of stripes
+     */
+    inline std::size_t size() const
+    {
+      return _n_stripes;
+    }
+
+    /*!
+     \brief Bucket to stripe mapping
+     \param bucket : bucket number
+     \return number of the stripe protecting bucket
+     */
+    inline std::size_t stripe(std::size_t bucket) const
+    {
+      return bucket % _n_stripes;
+    }
+
+    /*!
+     \brief Accessor
+     \param s : stripe number
+     \pre s < size() (checked by assertion)
+     \return lock of stripe s
+     */
+    inline LOCK & operator[] (std::size_t s)
+    {
+      assert(s < _n_stripes);
+      return _stripes[s].value;
+    }
+
+    /*!
+     \brief Deadlock-free acquisition of several stripes
+     \param stripes : stripe numbers, may contain duplicates
+     \post stripes is sorted without duplicates and all its stripes are locked.
+     Stripes are acquired in increasing order, so any two threads locking sets of stripes
+     this way cannot deadlock
+     \note this call is blocking
+     */
+    void lock_all(std::vector<std::size_t> & stripes)
+    {
+      std::sort(stripes.begin(), stripes.end());
+      stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+      for (std::size_t s : stripes){
+        (*this)[s].lock();
+      }
+    }
+
+    /*!
+     \brief Release several stripes
+     \param stripes : stripe numbers
+     \pre all stripes have been locked by lock_all(stripes)
+     \post all stripes are unlocked (in decreasing order)
+     */
+    void unlock_all(std::vector<std::size_t> const & stripes)
+    {
+      for (auto it = stripes.rbegin(); it != stripes.rend(); ++it){
+        (*this)[*it].unlock();
+      }
+    }
+
+  private:
+    std::size_t _n_stripes; /*!< Number of stripes */
+    std::unique_ptr<tchecker_ext::cache_aligned_t<LOCK>[]> _stripes; /*!< Padded locks */
+  };
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_LOCK_STRIPES_HH
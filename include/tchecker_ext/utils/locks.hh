@@ -0,0 +1,431 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_LOCKS_HH
+#define TCHECKER_EXT_LOCKS_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "tchecker_ext/utils/lock_stripes.hh"
+
+/*!
+ \file locks.hh
+ \brief Lock policies sharing the interface of tchecker_ext::spinlock_t (lock, lock_once, unlock)
+ \note All the locks in this file are neither copyable nor movable, and they are not recursive
+ */
+
+namespace tchecker_ext {
+
+  /*!
+   \brief Hint to the processor that the caller is spinning
+   \note pause on x86, yield on ARM, nothing otherwise
+   */
+  inline void cpu_relax()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+
+  /*!
+   \class ttas_lock_t
+   \brief Test-and-test-and-set spin lock with bounded exponential backoff
+   \note Waiting threads only read the flag (which stays in their cache) and try to set it
+   once it has been observed free
+   */
+  class ttas_lock_t {
+  public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = true;
+
+    /*!
+     \brief Maximal number of pause instructions between two attempts
+     */
+    static constexpr unsigned int max_backoff = 1024;
+
+    /*!
+     \brief Constructor
+     \post this lock is unlocked
+     */
+    ttas_lock_t() = default;
+
+    ttas_lock_t(tchecker_ext::ttas_lock_t const &) = delete;
+    ttas_lock_t(tchecker_ext::ttas_lock_t &&) = delete;
+    ~ttas_lock_t() = default;
+    tchecker_ext::ttas_lock_t & operator= (tchecker_ext::ttas_lock_t const &) = delete;
+    tchecker_ext::ttas_lock_t & operator= (tchecker_ext::ttas_lock_t &&) = delete;
+
+    /*!
+     \brief Acquire the lock
+     \note this call is blocking
+     */
+    inline void lock()
+    {
+      unsigned int backoff = 1;
+      while (true) {
+        if (!_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire))
+          return;
+        for (unsigned int i = 0; i < backoff; ++i)
+          tchecker_ext::cpu_relax();
+        backoff = std::min(2*backoff, max_backoff);
+      }
+    }
+
+    /*!
+     \brief Try once to acquire the lock and return the result
+     \post lock acquired -> true; locked by different thread -> false
+     */
+    inline bool lock_once()
+    {
+      return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    /*!
+     \brief Release the lock
+     */
+    inline void unlock()
+    {
+      _locked.store(false, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<bool> _locked{false}; /*!< Lock flag */
+  };
+
+
+  /*!
+   \class ticket_lock_t
+   \brief Fair (FIFO) spin lock
+   \note Every thread takes a ticket and waits until it is served. Waiting threads back off
+   proportionally to their distance to the head of the queue
+   \note as every fair lock, it performs poorly when there are more threads than cores: the lock
+   is handed over to the next thread in line even if that thread is not running
+   */
+  class ticket_lock_t {
+  public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = true;
+
+    /*!
+     \brief Constructor
+     \post this lock is unlocked
+     */
+    ticket_lock_t() = default;
+
+    ticket_lock_t(tchecker_ext::ticket_lock_t const &) = delete;
+    ticket_lock_t(tchecker_ext::ticket_lock_t &&) = delete;
+    ~ticket_lock_t() = default;
+    tchecker_ext::ticket_lock_t & operator= (tchecker_ext::ticket_lock_t const &) = delete;
+    tchecker_ext::ticket_lock_t & operator= (tchecker_ext::ticket_lock_t &&) = delete;
+
+    /*!
+     \brief Acquire the lock
+     \note this call is blocking
+     */
+    inline void lock()
+    {
+      std::uint32_t const ticket = _next.fetch_add(1, std::memory_order_relaxed);
+      while (true) {
+        std::uint32_t const serving = _serving.load(std::memory_order_acquire);
+        if (serving == ticket)
+          return;
+        for (std::uint32_t i = 0; i < 32*(ticket - serving); ++i)
+          tchecker_ext::cpu_relax();
+      }
+    }
+
+    /*!
+     \brief Try once to acquire the lock and return the result
+     \post lock acquired -> true; locked by different thread -> false
+     \note succeeds only if nobody holds or waits for the lock
+     */
+    inline bool lock_once()
+    {
+      std::uint32_t serving = _serving.load(std::memory_order_acquire);
+      return _next.compare_exchange_strong(serving, serving+1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    /*!
+     \brief Release the lock
+     \pre the lock is held by the calling thread
+     */
+    inline void unlock()
+    {
+      _serving.store(_serving.load(std::memory_order_relaxed)+1, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<std::uint32_t> _next{0}; /*!< Next ticket */
+    std::atomic<std::uint32_t> _serving{0}; /*!< Ticket holding the lock */
+  };
+
+
+  /*!
+   \class mcs_lock_t
+   \brief MCS queue lock
+   \note Every waiting thread spins on a flag in its own queue node, hence the lock generates
+   no coherence traffic while waiting and is fair. Queue nodes are taken from a pool private
+   to each thread, so one thread can hold several MCS locks at once (as needed by
+   tchecker_ext::lock_stripes_t::lock_all)
+   \note as tchecker_ext::ticket_lock_t, it should not be used with more threads than cores
+   */
+  class mcs_lock_t {
+  public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = true;
+
+    /*!
+     \brief Constructor
+     \post this lock is unlocked
+     */
+    mcs_lock_t() = default;
+
+    mcs_lock_t(tchecker_ext::mcs_lock_t const &) = delete;
+    mcs_lock_t(tchecker_ext::mcs_lock_t &&) = delete;
+    ~mcs_lock_t() = default;
+    tchecker_ext::mcs_lock_t & operator= (tchecker_ext::mcs_lock_t const &) = delete;
+    tchecker_ext::mcs_lock_t & operator= (tchecker_ext::mcs_lock_t &&) = delete;
+
+    /*!
+     \brief Acquire the lock
+     \note this call is blocking
+     */
+    inline void lock()
+    {
+      qnode_t * q = get_qnode();
+      qnode_t * pred = _tail.exchange(q, std::memory_order_acq_rel);
+      if (pred != nullptr) {
+        pred->next.store(q, std::memory_order_release);
+        while (q->locked.load(std::memory_order_acquire))
+          tchecker_ext::cpu_relax();
+      }
+      _holder = q;
+    }
+
+    /*!
+     \brief Try once to acquire the lock and return the result
+     \post lock acquired -> true; locked by different thread -> false
+     */
+    inline bool lock_once()
+    {
+      qnode_t * q = get_qnode();
+      qnode_t * expected = nullptr;
+      if (_tail.compare_exchange_strong(expected, q, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        _holder = q;
+        return true;
+      }
+      put_qnode(q);
+      return false;
+    }
+
+    /*!
+     \brief Release the lock
+     \pre the lock is held by the calling thread
+     */
+    inline void unlock()
+    {
+      qnode_t * q = _holder;
+      qnode_t * next = q->next.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        qnode_t * expected = q;
+        if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+          put_qnode(q);
+          return;
+        }
+        // A successor is enqueuing itself
+        while ((next = q->next.load(std::memory_order_acquire)) == nullptr)
+          tchecker_ext::cpu_relax();
+      }
+      next->locked.store(false, std::memory_order_release);
+      put_qnode(q);
+    }
+
+  private:
+    /*!
+     \brief Queue node
+     */
+    struct alignas(tchecker_ext::cache_line_size) qnode_t {
+      std::atomic<qnode_t *> next{nullptr};
+      std::atomic<bool> locked{false};
+    };
+
+    /*!
+     \brief Pool of free queue nodes of the calling thread
+     */
+    struct qnode_pool_t {
+      std::vector<qnode_t *> free;
+
+      ~qnode_pool_t()
+      {
+        for (qnode_t * q : free)
+          delete q;
+      }
+    };
+
+    static inline qnode_pool_t & qnode_pool()
+    {
+      static thread_local qnode_pool_t pool;
+      return pool;
+    }
+
+    /*!
+     \brief Initialized queue node of the calling thread
+     */
+    static inline qnode_t * get_qnode()
+    {
+      qnode_pool_t & pool = qnode_pool();
+      qnode_t * q;
+      if (pool.free.empty())
+        q = new qnode_t;
+      else {
+        q = pool.free.back();
+        pool.free.pop_back();
+      }
+      q->next.store(nullptr, std::memory_order_relaxed);
+      q->locked.store(true, std::memory_order_relaxed);
+      return q;
+    }
+
+    /*!
+     \brief Give a queue node back to the pool of the calling thread
+     \pre no other thread references q
+     */
+    static inline void put_qnode(qnode_t * q)
+    {
+      qnode_pool().free.push_back(q);
+    }
+
+    std::atomic<qnode_t *> _tail{nullptr}; /*!< Last node in the queue */
+    qnode_t * _holder{nullptr}; /*!< Queue node of the holder, only accessed by the holder */
+  };
+
+
+  /*!
+   \class futex_lock_t
+   \brief Adaptive mutex: spins for a short while, then sleeps in the kernel
+   \note Three states: 0 unlocked, 1 locked, 2 locked with (possible) sleepers. Sleeping uses
+   futex on Linux and falls back to yielding elsewhere
+   */
+  class futex_lock_t {
+  public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = true;
+
+    /*!
+     \brief Number of attempts before going to sleep
+     */
+    static constexpr unsigned int spin_count = 128;
+
+    /*!
+     \brief Constructor
+     \post this lock is unlocked
+     */
+    futex_lock_t() = default;
+
+    futex_lock_t(tchecker_ext::futex_lock_t const &) = delete;
+    futex_lock_t(tchecker_ext::futex_lock_t &&) = delete;
+    ~futex_lock_t() = default;
+    tchecker_ext::futex_lock_t & operator= (tchecker_ext::futex_lock_t const &) = delete;
+    tchecker_ext::futex_lock_t & operator= (tchecker_ext::futex_lock_t &&) = delete;
+
+    /*!
+     \brief Acquire the lock
+     \note this call is blocking
+     */
+    inline void lock()
+    {
+      int c = 0;
+      for (unsigned int i = 0; i < spin_count; ++i) {
+        c = 0;
+        if (_state.compare_exchange_weak(c, 1, std::memory_order_acquire, std::memory_order_relaxed))
+          return;
+        tchecker_ext::cpu_relax();
+      }
+      // Announce a sleeper and wait
+      if (c != 2)
+        c = _state.exchange(2, std::memory_order_acquire);
+      while (c != 0) {
+        wait(2);
+        c = _state.exchange(2, std::memory_order_acquire);
+      }
+    }
+
+    /*!
+     \brief Try once to acquire the lock and return the result
+     \post lock acquired -> true; locked by different thread -> false
+     */
+    inline bool lock_once()
+    {
+      int c = 0;
+      return _state.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    /*!
+     \brief Release the lock
+     \pre the lock is held by the calling thread
+     */
+    inline void unlock()
+    {
+      if (_state.exchange(0, std::memory_order_release) == 2)
+        wake_one();
+    }
+
+  private:
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex needs a plain int");
+
+    /*!
+     \brief Sleep while the state is equal to value
+     */
+    inline void wait(int value)
+    {
+#if defined(__linux__)
+      syscall(SYS_futex, reinterpret_cast<int *>(&_state), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#else
+      (void)value;
+      std::this_thread::yield();
+#endif
+    }
+
+    /*!
+     \brief Wake up one sleeper
+     */
+    inline void wake_one()
+    {
+#if defined(__linux__)
+      syscall(SYS_futex, reinterpret_cast<int *>(&_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+    }
+
+    std::atomic<int> _state{0}; /*!< Lock state */
+  };
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_LOCKS_HH
@@ -0,0 +1,155 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_MEMORY_HH
+#define TCHECKER_EXT_MEMORY_HH
+
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/*!
+ \file memory.hh
+ \brief Memory usage report, and huge page aligned blocks
+ */
+
+namespace tchecker_ext {
+
+  namespace memory {
+
+    /*!
+     \brief Size of a huge page (bytes)
+     */
+    constexpr std::size_t huge_page_size = 2*1024*1024;
+
+    /*!
+     \class usage_t
+     \brief Snapshot of the memory usage of the process
+     \note all sizes are in bytes, 0 if unavailable on this platform
+     */
+    struct usage_t {
+      std::size_t rss = 0;            /*!< Resident set size */
+      std::size_t huge_pages = 0;     /*!< Resident memory backed by transparent huge pages */
+      std::size_t heap_reserved = 0;  /*!< Memory obtained by malloc from the system */
+      std::size_t heap_in_use = 0;    /*!< Memory in allocated malloc chunks (pool blocks included) */
+    };
+
+    /*!
+     \brief Current memory usage
+     \return snapshot of the memory usage of the process
+     */
+    tchecker_ext::memory::usage_t usage();
+
+    /*!
+     \brief Current resident set size
+     \return resident set size of the process (bytes), 0 if unavailable on this platform
+     \note cheaper than usage(), meant to be polled while the algorithm runs
+     */
+    std::size_t resident();
+
+    /*!
+     \brief Output memory usage
+     \param os : output stream
+     \param u : memory usage
+     \post u has been output to os, one key/value per line
+     \return os
+     */
+    std::ostream & operator<< (std::ostream & os, tchecker_ext::memory::usage_t const & u);
+
+    /*!
+     \class block_allocator_t
+     \brief Bump allocator over huge page aligned blocks
+     \note Blocks are mapped from the system, aligned on huge_page_size, and their size is a multiple of
+     huge_page_size. Each block is twice as large as the previous one (up to max_block_size), so the number
+     of blocks is logarithmic in the allocated memory. If huge pages are requested, each block is advised
+     MADV_HUGEPAGE when it is mapped: only the blocks of this allocator are advised
+     \note memory is only given back to the system by release_all() and by the destructor. Not thread safe
+     */
+    class block_allocator_t {
+    public:
+      /*!
+       \brief Maximal size of a block (bytes)
+       */
+      static constexpr std::size_t max_block_size = 512 * huge_page_size;
+
+      /*!
+       \brief Constructor
+       \param huge_pages : whether the blocks are advised for transparent huge pages
+       \post this has no block
+       */
+      explicit block_allocator_t(bool huge_pages = false);
+
+      block_allocator_t(tchecker_ext::memory::block_allocator_t const &) = delete;
+      block_allocator_t(tchecker_ext::memory::block_allocator_t &&) = delete;
+
+      /*!
+       \brief Destructor
+       \post all blocks have been given back to the system
+       */
+      ~block_allocator_t();
+
+      tchecker_ext::memory::block_allocator_t & operator= (tchecker_ext::memory::block_allocator_t const &) = delete;
+      tchecker_ext::memory::block_allocator_t & operator= (tchecker_ext::memory::block_allocator_t &&) = delete;
+
+      /*!
+       \brief Allocation
+       \param bytes : number of bytes
+       \param align : alignment, a power of 2 not greater than huge_page_size
+       \return pointer to bytes uninitialized bytes aligned on align
+       \throw std::bad_alloc : if a block cannot be mapped
+       */
+      void * allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t));
+
+      /*!
+       \brief Release
+       \post all blocks have been given back to the system, all pointers returned by allocate() have been
+       invalidated
+       */
+      void release_all();
+
+      /*!
+       \brief Accessor
+       \return number of bytes mapped by this
+       */
+      inline std::size_t reserved() const
+      {
+        return _reserved;
+      }
+
+      /*!
+       \brief Accessor
+       \return number of bytes allocated from this (alignment padding included)
+       */
+      inline std::size_t used() const
+      {
+        return _used;
+      }
+
+    private:
+      /*!
+       \brief Map a block
+       \param bytes : minimal size of the block
+       \post a new block of at least bytes bytes is the current block
+       \throw std::bad_alloc : if the block cannot be mapped
+       */
+      void map_block(std::size_t bytes);
+
+      bool const _huge_pages; /*!< Whether blocks are advised for huge pages */
+      std::vector<std::pair<char *, std::size_t>> _blocks; /*!< Mapped blocks (address and size) */
+      char * _head; /*!< First free byte of the current block */
+      char * _end; /*!< End of the current block */
+      std::size_t _next_block_size; /*!< Size of the next block */
+      std::size_t _reserved; /*!< Mapped bytes */
+      std::size_t _used; /*!< Allocated bytes */
+    };
+
+  } // end of namespace memory
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_MEMORY_HH
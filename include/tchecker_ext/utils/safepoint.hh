@@ -0,0 +1,135 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_SAFEPOINT_HH
+#define TCHECKER_EXT_SAFEPOINT_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+/*!
+ \file safepoint.hh
+ \brief Stop-the-world phases among a fixed number of workers
+ */
+
+namespace tchecker_ext {
+
+  /*!
+   \class safepoint_t
+   \brief Runs an action while all workers are parked
+   \note A worker requests a stop-the-world phase with request(). Every worker polls the safepoint at
+   points where it holds no lock and no reference to a node that is being worked on. The last worker
+   to park runs the action, then all workers resume. A worker that terminates leaves the safepoint, so
+   that the others do not wait for it
+   */
+  class safepoint_t {
+  public:
+    /*!
+     \brief Constructor
+     \param n_workers : number of workers
+     \param action : action run while all workers are parked
+     */
+    safepoint_t(unsigned int n_workers, std::function<void()> action)
+    : _requested(false),
+      _n_workers(n_workers),
+      _n_parked(0),
+      _generation(0),
+      _action(std::move(action))
+    {}
+
+    safepoint_t(tchecker_ext::safepoint_t const &) = delete;
+    safepoint_t(tchecker_ext::safepoint_t &&) = delete;
+    ~safepoint_t() = default;
+    tchecker_ext::safepoint_t & operator= (tchecker_ext::safepoint_t const &) = delete;
+    tchecker_ext::safepoint_t & operator= (tchecker_ext::safepoint_t &&) = delete;
+
+    /*!
+     \brief Request a stop-the-world phase
+     \post the action is run once all workers have polled or left
+     \note thread safe
+     */
+    inline void request()
+    {
+      _requested.store(true, std::memory_order_release);
+    }
+
+    /*!
+     \brief Poll
+     \return true if the calling worker has been parked, false if no phase was requested
+     \post if a phase was requested, the calling worker has been parked until the action has been run
+     \note thread safe
+     */
+    bool poll()
+    {
+      if (!_requested.load(std::memory_order_acquire))
+        return false;
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (!_requested.load(std::memory_order_relaxed))
+        return false;
+      ++_n_parked;
+      if (_n_parked == _n_workers)
+        run();
+      else {
+        std::size_t const generation = _generation;
+        _resumed.wait(lock, [&] () { return _generation != generation; });
+      }
+      return true;
+    }
+
+    /*!
+     \brief Leave
+     \post the calling worker does not take part in stop-the-world phases anymore. If it was the last
+     worker a pending phase was waiting for, the action has been run
+     \note thread safe
+     */
+    void leave()
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      --_n_workers;
+      if (_requested.load(std::memory_order_relaxed) && (_n_workers > 0) && (_n_parked == _n_workers))
+        run();
+    }
+
+    /*!
+     \brief Accessor
+     \return number of stop-the-world phases that have been run
+     \pre no worker takes part in phases anymore
+     */
+    inline std::size_t runs() const
+    {
+      return _generation;
+    }
+
+  private:
+    /*!
+     \brief Run the action and resume the parked workers
+     \pre _mutex is held, all remaining workers are parked
+     */
+    void run()
+    {
+      _action();
+      _n_parked = 0;
+      ++_generation;
+      _requested.store(false, std::memory_order_release);
+      _resumed.notify_all();
+    }
+
+    std::atomic_bool _requested; /*!< Whether a phase has been requested */
+    std::mutex _mutex; /*!< Protects the counters below */
+    std::condition_variable _resumed; /*!< Signals the end of a phase */
+    unsigned int _n_workers; /*!< Number of workers taking part in phases */
+    unsigned int _n_parked; /*!< Number of parked workers */
+    std::size_t _generation; /*!< Number of phases that have been run */
+    std::function<void()> _action; /*!< Action run while all workers are parked */
+  };
+
+} // end of namespace tchecker_ext
+
+#endif // TCHECKER_EXT_SAFEPOINT_HH
@@ -0,0 +1,157 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#ifndef TCHECKER_EXT_SHARED_OBJECTS_HH
+#define TCHECKER_EXT_SHARED_OBJECTS_HH
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "tchecker/utils/allocation_size.hh"
+#include "tchecker/utils/shared_objects.hh"
+
+/*!
+ \file shared_objects.hh
+ \brief Shared objects with an atomic reference counter
+ */
+
+namespace tchecker_ext {
+
+  /*!
+   \class make_atomic_shared_t
+   \brief Shared object of type T with an atomic reference counter, in place of tchecker::make_shared_t
+   \tparam T : type of object
+   \tparam REFCOUNT : unsigned integral type of the reference counter
+   \tparam ARGS : other template arguments of tchecker::make_shared_t (ignored)
+   \note objects of this type are referenced by tchecker::intrusive_shared_ptr_t and allocated from the pools
+   of tchecker, as objects of type tchecker::make_shared_t<T, REFCOUNT, ARGS...>. The reference counter can
+   change concurrently: increments are relaxed (a thread can only add a reference to an object it already
+   references), decrements release the accesses of the thread, and the last decrement acquires those of the
+   other threads. Hence an object whose counter is observed as 0 by refcount() can be destructed
+   */
+  template <class T, class REFCOUNT = std::size_t, class ... ARGS>
+  class make_atomic_shared_t final : public T {
+    static_assert(std::is_integral<REFCOUNT>::value && std::is_unsigned<REFCOUNT>::value,
+                  "REFCOUNT should be an unsigned integral type");
+  public:
+    /*!
+     \brief Constructor
+     \param args : arguments to a constructor of T
+     \post this has been built from args, with reference counter 0
+     */
+    template <class ... CARGS>
+    explicit make_atomic_shared_t(CARGS && ... args) : T(std::forward<CARGS>(args)...), _refcount(0)
+    {}
+
+    /*!
+     \brief Copy constructor (deleted)
+     */
+    make_atomic_shared_t(tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> const &) = delete;
+
+    /*!
+     \brief Move constructor (deleted)
+     */
+    make_atomic_shared_t(tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> &&) = delete;
+
+    /*!
+     \brief Destructor
+     */
+    ~make_atomic_shared_t() = default;
+
+    /*!
+     \brief Assignment operator (deleted)
+     */
+    tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> &
+    operator= (tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> const &) = delete;
+
+    /*!
+     \brief Move assignment operator (deleted)
+     */
+    tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> &
+    operator= (tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...> &&) = delete;
+
+    /*!
+     \brief Accessor
+     \return reference counter of this
+     \note the value can be outdated as soon as it is returned, unless the caller holds the only reference
+     */
+    inline REFCOUNT refcount() const
+    {
+      return _refcount.load(std::memory_order_acquire);
+    }
+  private:
+    template <class U> friend class tchecker::intrusive_shared_ptr_t;
+
+    /*!
+     \brief Increment the reference counter
+     */
+    inline void incr_refcount()
+    {
+      [[maybe_unused]] REFCOUNT const previous = _refcount.fetch_add(1, std::memory_order_relaxed);
+      assert(previous < std::numeric_limits<REFCOUNT>::max());
+    }
+
+    /*!
+     \brief Decrement the reference counter
+     \post the accesses of the threads that have released a reference to this happen before the return
+     of the last decrement
+     */
+    inline void decr_refcount()
+    {
+      REFCOUNT const previous = _refcount.fetch_sub(1, std::memory_order_release);
+      assert(previous > 0);
+      if (previous == 1)
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    std::atomic<REFCOUNT> _refcount; /*!< Reference counter */
+  };
+
+
+  /*!
+   \class is_atomic_shared_t
+   \brief Whether a shared type has an atomic reference counter
+   */
+  template <class SHARED>
+  struct is_atomic_shared_t : std::false_type {};
+
+  template <class T, class REFCOUNT, class ... ARGS>
+  struct is_atomic_shared_t<tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...>> : std::true_type {};
+
+} // end of namespace tchecker_ext
+
+
+
+namespace tchecker {
+
+  /*!
+   \class allocation_size_t
+   \brief Specialization of tchecker::allocation_size_t to shared objects with an atomic reference counter
+   */
+  template <class T, class REFCOUNT, class ... ARGS>
+  class allocation_size_t<tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...>> {
+  public:
+    /*!
+     \brief Allocation size
+     \param args : arguments to a constructor of T
+     \return allocation size of an object built from args
+     */
+    template <class ... CARGS>
+    static constexpr std::size_t alloc_size(CARGS && ... args)
+    {
+      return sizeof(tchecker_ext::make_atomic_shared_t<T, REFCOUNT, ARGS...>) - sizeof(T)
+      + tchecker::allocation_size_t<T>::alloc_size(std::forward<CARGS>(args)...);
+    }
+  };
+
+} // end of namespace tchecker
+
+#endif // TCHECKER_EXT_SHARED_OBJECTS_HH
@@ -23,6 +23,11 @@ namespace tchecker_ext {
    */
   class spinlock_t: public tchecker::spinlock_t {
   public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = true;
+    
     /*!
      \brief Constructor
      \post this lock is unlocked
@@ -68,6 +73,41 @@ namespace tchecker_ext {
     
   };
   
+  /*!
+   \class null_lock_t
+   \brief Lock that does nothing, for single-threaded runs
+   \note Containers parametrized by null_lock_t are not thread safe. They check concurrent
+   to skip bookkeeping that is only needed when several threads share them
+   */
+  class null_lock_t {
+  public:
+    /*!
+     \brief Whether this lock synchronizes threads
+     */
+    static constexpr bool concurrent = false;
+    
+    /*!
+     \brief Does nothing
+     */
+    inline void lock()
+    {}
+    
+    /*!
+     \brief Does nothing
+     \return true
+     */
+    inline bool lock_once()
+    {
+      return true;
+    }
+    
+    /*!
+     \brief Does nothing
+     */
+    inline void unlock()
+    {}
+  };
+  
   template<class T>
   class spinlocked_T_t{
   public:
@@ -20,7 +20,21 @@ namespace tchecker_ext {
     options_t::options_t(tchecker_ext::covreach_ext::options_t && options)
     : tchecker::covreach::options_t(static_cast<tchecker::covreach::options_t&&>(options)),
     _num_threads(options._num_threads),
-    _n_notify(options._n_notify)
+    _n_notify(options._n_notify),
+    _reach_only(options._reach_only),
+    _lock_stripes(options._lock_stripes),
+    _lock_policy(options._lock_policy),
+    _atomic_refcount(options._atomic_refcount),
+    _huge_pages(options._huge_pages),
+    _intern_discrete(options._intern_discrete),
+    _pack_discrete(options._pack_discrete),
+    _intern_zones(options._intern_zones),
+    _compress_zones(options._compress_zones),
+    _merge_zones(options._merge_zones),
+    _federation_cover(options._federation_cover),
+    _memory_limit(options._memory_limit),
+    _compaction_threshold(options._compaction_threshold),
+    _fast_exit(options._fast_exit)
     {
       options._os = nullptr;
     }
@@ -31,6 +45,20 @@ namespace tchecker_ext {
       if (this != &options) {
         _num_threads = options._num_threads;
         _n_notify = options._n_notify;
+        _reach_only = options._reach_only;
+        _lock_stripes = options._lock_stripes;
+        _lock_policy = options._lock_policy;
+        _atomic_refcount = options._atomic_refcount;
+        _huge_pages = options._huge_pages;
+        _intern_discrete = options._intern_discrete;
+        _pack_discrete = options._pack_discrete;
+        _intern_zones = options._intern_zones;
+        _compress_zones = options._compress_zones;
+        _merge_zones = options._merge_zones;
+        _federation_cover = options._federation_cover;
+        _memory_limit = options._memory_limit;
+        _compaction_threshold = options._compaction_threshold;
+        _fast_exit = options._fast_exit;
       }
       return *this;
     }
@@ -46,14 +74,117 @@ namespace tchecker_ext {
     {
       return _n_notify;
     }
+  
+    bool options_t::reach_only() const
+    {
+      return _reach_only;
+    }
+  
+    std::size_t options_t::lock_stripes() const
+    {
+      return _lock_stripes;
+    }
+  
+    enum options_t::lock_policy_t options_t::lock_policy() const
+    {
+      return _lock_policy;
+    }
+  
+    bool options_t::atomic_refcount() const
+    {
+      return _atomic_refcount;
+    }
+  
+    bool options_t::huge_pages() const
+    {
+      return _huge_pages;
+    }
+  
+    bool options_t::intern_discrete() const
+    {
+      return _intern_discrete;
+    }
+  
+    bool options_t::pack_discrete() const
+    {
+      return _pack_discrete;
+    }
+  
+    bool options_t::intern_zones() const
+    {
+      return _intern_zones;
+    }
+  
+    bool options_t::compress_zones() const
+    {
+      return _compress_zones;
+    }
+  
+    bool options_t::merge_zones() const
+    {
+      return _merge_zones;
+    }
+  
+    bool options_t::federation_cover() const
+    {
+      return _federation_cover;
+    }
+  
+    std::size_t options_t::memory_limit() const
+    {
+      return _memory_limit;
+    }
+  
+    double options_t::compaction_threshold() const
+    {
+      return _compaction_threshold;
+    }
+  
+    bool options_t::fast_exit() const
+    {
+      return _fast_exit;
+    }
     
     
     void options_t::set_option(std::string const & key, std::string const & value, tchecker::log_t & log)
     {
       if (key == "n"){
         set_n_notify(value, log);
+      } else if ((key == "c") && (value == "federation")){
+        // Covering by federations completes inclusion covering
+        _federation_cover = true;
+        tchecker::covreach::options_t::set_option(key, "inclusion", log);
+      } else if (key == "c"){
+        _federation_cover = false;
+        tchecker::covreach::options_t::set_option(key, value, log);
       } else if (key == "t"){
         set_num_threads(value, log);
+      } else if (key == "reach-only"){
+        _reach_only = true;
+      } else if (key == "lock-stripes"){
+        set_lock_stripes(value, log);
+      } else if (key == "lock"){
+        set_lock_policy(value, log);
+      } else if (key == "atomic-refcount"){
+        _atomic_refcount = true;
+      } else if (key == "huge-pages"){
+        _huge_pages = true;
+      } else if (key == "intern-discrete"){
+        _intern_discrete = true;
+      } else if (key == "pack-discrete"){
+        _pack_discrete = true;
+      } else if (key == "intern-zones"){
+        _intern_zones = true;
+      } else if (key == "compress-zones"){
+        _compress_zones = true;
+      } else if (key == "merge-zones"){
+        _merge_zones = true;
+      } else if (key == "memory-limit"){
+        set_memory_limit(value, log);
+      } else if (key == "compact"){
+        set_compaction_threshold(value, log);
+      } else if (key == "fast-exit"){
+        _fast_exit = true;
       }else{
         tchecker::covreach::options_t::set_option(key, value, log);
       }
@@ -80,10 +211,67 @@ namespace tchecker_ext {
       }
     }
     
+    void options_t::set_lock_stripes(std::string const &value, tchecker::log_t &log)
+    {
+      if (!tchecker_ext::utils::to_numeric(value, _lock_stripes)){
+        log.error("Invalid value: " + value + " for command line option --lock-stripes, expecting an unsigned integer");
+        throw std::runtime_error("Invalid value: " + value +
+                                 " for command line option --lock-stripes, expecting an unsigned integer");
+      }
+    }
+    
+    void options_t::set_lock_policy(std::string const &value, tchecker::log_t &log)
+    {
+      if (value == "tas")
+        _lock_policy = LOCK_TAS;
+      else if (value == "ttas")
+        _lock_policy = LOCK_TTAS;
+      else if (value == "ticket")
+        _lock_policy = LOCK_TICKET;
+      else if (value == "mcs")
+        _lock_policy = LOCK_MCS;
+      else if (value == "futex")
+        _lock_policy = LOCK_FUTEX;
+      else {
+        log.error("Unknown lock: " + value + " for command line option --lock, expecting tas, ttas, ticket, mcs or futex");
+        throw std::runtime_error("Unknown lock: " + value +
+                                 " for command line option --lock, expecting tas, ttas, ticket, mcs or futex");
+      }
+    }
+    
+    void options_t::set_memory_limit(std::string const &value, tchecker::log_t &log)
+    {
+      if (!tchecker_ext::utils::to_numeric(value, _memory_limit)){
+        log.error("Invalid value: " + value + " for command line option --memory-limit, expecting an unsigned integer");
+        throw std::runtime_error("Invalid value: " + value +
+                                 " for command line option --memory-limit, expecting an unsigned integer");
+      }
+    }
+    
+    void options_t::set_compaction_threshold(std::string const &value, tchecker::log_t &log)
+    {
+      if (!tchecker_ext::utils::to_numeric(value, _compaction_threshold) ||
+          (_compaction_threshold <= 0.0) || (_compaction_threshold >= 1.0)){
+        log.error("Invalid value: " + value + " for command line option --compact, expecting a number in (0, 1)");
+        throw std::runtime_error("Invalid value: " + value +
+                                 " for command line option --compact, expecting a number in (0, 1)");
+      }
+    }
+    
     void options_t::check_mandatory_options(tchecker::log_t & log) const
     {
       if (_algorithm_model == UNKNOWN)
         log.error("model must be set, use -m command line option");
+      if (_reach_only && (output_format() == DOT))
+        log.error("DOT output needs the edges of the graph, it cannot be used together with --reach-only");
+      if (_compress_zones && (!_reach_only || (node_covering() != INCLUSION)))
+        log.error("--compress-zones needs --reach-only and inclusion covering (-c inclusion)");
+      if ((_memory_limit > 0) && !_reach_only)
+        log.error("--memory-limit needs --reach-only");
+      if (_federation_cover && !_reach_only)
+        log.error("-c federation needs --reach-only");
+      if (_federation_cover && _compress_zones)
+        log.error("-c federation cannot be used together with --compress-zones");
     }
     
     
@@ -91,6 +279,42 @@ namespace tchecker_ext {
     {
       tchecker::covreach::options_t::describe(os);
       os << "-t threads corresponds to the number of worker threads:" << std::endl;
+      os << "-c federation    inclusion covering, and covering by the union of the zones of the stored nodes" << std::endl;
+      os << "                 with the same discrete part (needs --reach-only, not with --compress-zones)" << std::endl;
+      os << "--reach-only     only decide reachability, the graph stores no edges (no DOT output)" << std::endl;
+      os << "--lock-stripes n number of locks protecting the nodes table (default: one lock per bucket)" << std::endl;
+      os << "--lock l         locks of the nodes table and the waiting container, with l one of:" << std::endl;
+      os << "                 tas     test-and-set spin lock (default)" << std::endl;
+      os << "                 ttas    test-and-test-and-set spin lock with exponential backoff" << std::endl;
+      os << "                 ticket  fair ticket lock" << std::endl;
+      os << "                 mcs     fair MCS queue lock" << std::endl;
+      os << "                 futex   spins then sleeps (Linux futex)" << std::endl;
+      os << "                 ticket and mcs should not be used with more threads than cores" << std::endl;
+      os << "--atomic-refcount nodes have atomic reference counters: references to nodes are released without" << std::endl;
+      os << "                 locking when no side table tracks them (without --intern-discrete, --intern-zones," << std::endl;
+      os << "                 --compress-zones, --merge-zones, --memory-limit and -c federation). Ignored with" << std::endl;
+      os << "                 a single thread" << std::endl;
+      os << "--huge-pages     back the arenas of compressed zones (--compress-zones, --memory-limit) by" << std::endl;
+      os << "                 transparent huge pages (Linux). The node pools are tchecker pools, they grow by" << std::endl;
+      os << "                 chunks of --block-size nodes and are not affected" << std::endl;
+      os << "--intern-discrete stored nodes share equal tuples of locations and integer valuations" << std::endl;
+      os << "--pack-discrete  hash (and intern with --intern-discrete) the discrete parts of nodes from an encoding" << std::endl;
+      os << "                 on at most two 64 bits words, with bit widths derived from the ranges of the" << std::endl;
+      os << "                 integer variables and the numbers of locations of the processes" << std::endl;
+      os << "--intern-zones   stored nodes share equal zones" << std::endl;
+      os << "--compress-zones store the zones of expanded nodes as minimal sets of constraints" << std::endl;
+      os << "                 (needs --reach-only and -c inclusion)" << std::endl;
+      os << "--merge-zones    replace a node and a stored node with the same discrete part by a single node" << std::endl;
+      os << "                 when the union of their zones is convex" << std::endl;
+      os << "--memory-limit m node payload budget of m MB: when the nodes stored by the graph (nodes and their" << std::endl;
+      os << "                 zones) exceed m MB, until below 90%, compress then evict passed nodes that did not" << std::endl;
+      os << "                 cover any node for a while. Evicted nodes may be explored again (needs --reach-only," << std::endl;
+      os << "                 nodes are only compressed with -c inclusion). This is not a limit of the process:" << std::endl;
+      os << "                 discrete parts, edges, waiting lists and side tables are not counted" << std::endl;
+      os << "--compact f      stop the workers and relocate the stored nodes bucket by bucket when more than a" << std::endl;
+      os << "                 fraction f in (0, 1) of the nodes have been removed since the last compaction" << std::endl;
+      os << "--fast-exit      do not free the graph once the results have been output: its memory is returned" << std::endl;
+      os << "                 to the operating system when the process exits (command line use)" << std::endl;
       return os;
     }
     
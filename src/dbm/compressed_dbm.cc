@@ -0,0 +1,254 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "tchecker_ext/dbm/compressed_dbm.hh"
+#include "tchecker_ext/dbm/simd.hh"
+
+#include <tchecker_ext/config.hh>
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+#define DBM(i,j)          dbm[(i)*dim+(j)]
+
+    /*!
+     \brief Store a bound into a 32 bits or a 16 bits bound
+     */
+    static inline void set_db(tchecker::dbm::db_t & dst, tchecker::dbm::db_t db){
+      dst = db;
+    }
+
+    static inline void set_db(tchecker_ext::dbm_ext::db16_t & dst, tchecker::dbm::db_t db){
+      dst = tchecker_ext::dbm_ext::to_db16(db);
+    }
+
+
+    template <class CONSTRAINT>
+    static std::size_t minimal_constraints_impl(tchecker::dbm::db_t const * dbm,
+                                                tchecker::clock_id_t dim,
+                                                CONSTRAINT * constraints){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+      assert(constraints != nullptr);
+      assert(tchecker::dbm::is_consistent(dbm, dim));
+      assert(tchecker::dbm::is_tight(dbm, dim));
+
+      std::size_t n = 0;
+      auto add = [&] (tchecker::clock_id_t i, tchecker::clock_id_t j) {
+        constraints[n].i = static_cast<decltype(constraints[n].i)>(i);
+        constraints[n].j = static_cast<decltype(constraints[n].j)>(j);
+        set_db(constraints[n].db, DBM(i, j));
+        ++n;
+      };
+
+      // Classes of clocks on a zero cycle, represented by their smallest clock
+      std::vector<tchecker::clock_id_t> rep(dim), last(dim);
+      for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+        rep[i] = i;
+        for (tchecker::clock_id_t j = 0; j < i; ++j) {
+          if ((rep[j] == j) && (tchecker::dbm::sum(DBM(i, j), DBM(j, i)) == tchecker::dbm::LE_ZERO)) {
+            rep[i] = j;
+            break;
+          }
+        } // j
+      } // i
+
+      // A cycle through the clocks of each class: smallest -> ... -> largest -> smallest
+      for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+        last[i] = i;
+        if (rep[i] != i) {
+          add(last[rep[i]], i);
+          last[rep[i]] = i;
+        }
+      } // i
+      for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+        if ((rep[i] == i) && (last[i] != i))
+          add(last[i], i);
+      } // i
+
+      // Between classes: no zero cycle, a constraint is redundant iff it is implied by a path through a third class
+      for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+        if (rep[i] != i)
+          continue;
+        for (tchecker::clock_id_t j = 0; j < dim; ++j) {
+          if ((rep[j] != j) || (j == i) || (DBM(i, j) == tchecker::dbm::LT_INFINITY))
+            continue;
+          bool redundant = false;
+          for (tchecker::clock_id_t k = 0; (k < dim) && !redundant; ++k) {
+            if ((rep[k] != k) || (k == i) || (k == j))
+              continue;
+            redundant = (tchecker::dbm::sum(DBM(i, k), DBM(k, j)) <= DBM(i, j));
+          } // k
+          if (!redundant)
+            add(i, j);
+        } // j
+      } // i
+
+      return n;
+    } // minimal_constraints_impl
+
+
+    template <class CONSTRAINT>
+    static void expand_constraints_impl(tchecker::dbm::db_t * dbm,
+                                        tchecker::clock_id_t dim,
+                                        CONSTRAINT const * constraints,
+                                        std::size_t n){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+      assert((constraints != nullptr) || (n == 0));
+
+      for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+        for (tchecker::clock_id_t j = 0; j < dim; ++j)
+          DBM(i, j) = tchecker::dbm::LT_INFINITY;
+        DBM(i, i) = tchecker::dbm::LE_ZERO;
+      } // i
+
+      for (std::size_t k = 0; k < n; ++k) {
+        assert((constraints[k].i < dim) && (constraints[k].j < dim));
+        DBM(constraints[k].i, constraints[k].j) = tchecker_ext::dbm_ext::to_db(constraints[k].db);
+      } // k
+
+      enum tchecker::dbm::status_t status = tchecker_ext::dbm_ext::tighten(dbm, dim);
+      assert(status == tchecker::dbm::NON_EMPTY);
+      (void)status;
+    } // expand_constraints_impl
+
+
+    template <class CONSTRAINT>
+    static bool is_le_impl(tchecker::dbm::db_t const * dbm,
+                           tchecker::clock_id_t dim,
+                           CONSTRAINT const * constraints,
+                           std::size_t n){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+      assert((constraints != nullptr) || (n == 0));
+      assert(tchecker::dbm::is_tight(dbm, dim));
+
+      for (std::size_t k = 0; k < n; ++k) {
+        assert((constraints[k].i < dim) && (constraints[k].j < dim));
+        if (DBM(constraints[k].i, constraints[k].j) > tchecker_ext::dbm_ext::to_db(constraints[k].db))
+          return false;
+      } // k
+      return true;
+    } // is_le_impl
+
+
+    template <class CONSTRAINT>
+    static bool may_be_le_impl(CONSTRAINT const * constraints,
+                               std::size_t n,
+                               tchecker::dbm::db_t const * dbm,
+                               tchecker::clock_id_t dim){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+      assert((constraints != nullptr) || (n == 0));
+
+      for (std::size_t k = 0; k < n; ++k) {
+        assert((constraints[k].i < dim) && (constraints[k].j < dim));
+        if (tchecker_ext::dbm_ext::to_db(constraints[k].db) > DBM(constraints[k].i, constraints[k].j))
+          return false;
+      } // k
+      return true;
+    } // may_be_le_impl
+
+
+    bool fits_constraint16(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim){
+      return (dim <= 256) && tchecker_ext::dbm_ext::fits_db16(dbm, dim);
+    } // fits_constraint16
+
+
+    std::size_t minimal_constraints(tchecker::dbm::db_t const * dbm,
+                                    tchecker::clock_id_t dim,
+                                    tchecker_ext::dbm_ext::constraint_t * constraints){
+      assert(dim <= 65536);
+      return minimal_constraints_impl(dbm, dim, constraints);
+    } // minimal_constraints
+
+
+    std::size_t minimal_constraints(tchecker::dbm::db_t const * dbm,
+                                    tchecker::clock_id_t dim,
+                                    tchecker_ext::dbm_ext::constraint16_t * constraints){
+      assert(tchecker_ext::dbm_ext::fits_constraint16(dbm, dim));
+      return minimal_constraints_impl(dbm, dim, constraints);
+    } // minimal_constraints
+
+
+    void expand_constraints(tchecker::dbm::db_t * dbm,
+                            tchecker::clock_id_t dim,
+                            tchecker_ext::dbm_ext::constraint_t const * constraints,
+                            std::size_t n){
+      expand_constraints_impl(dbm, dim, constraints, n);
+    } // expand_constraints
+
+
+    void expand_constraints(tchecker::dbm::db_t * dbm,
+                            tchecker::clock_id_t dim,
+                            tchecker_ext::dbm_ext::constraint16_t const * constraints,
+                            std::size_t n){
+      expand_constraints_impl(dbm, dim, constraints, n);
+    } // expand_constraints
+
+
+    bool is_le(tchecker::dbm::db_t const * dbm,
+               tchecker::clock_id_t dim,
+               tchecker_ext::dbm_ext::constraint_t const * constraints,
+               std::size_t n){
+      return is_le_impl(dbm, dim, constraints, n);
+    } // is_le
+
+
+    bool is_le(tchecker::dbm::db_t const * dbm,
+               tchecker::clock_id_t dim,
+               tchecker_ext::dbm_ext::constraint16_t const * constraints,
+               std::size_t n){
+      return is_le_impl(dbm, dim, constraints, n);
+    } // is_le
+
+
+    bool may_be_le(tchecker_ext::dbm_ext::constraint_t const * constraints,
+                   std::size_t n,
+                   tchecker::dbm::db_t const * dbm,
+                   tchecker::clock_id_t dim){
+      return may_be_le_impl(constraints, n, dbm, dim);
+    } // may_be_le
+
+
+    bool may_be_le(tchecker_ext::dbm_ext::constraint16_t const * constraints,
+                   std::size_t n,
+                   tchecker::dbm::db_t const * dbm,
+                   tchecker::clock_id_t dim){
+      return may_be_le_impl(constraints, n, dbm, dim);
+    } // may_be_le
+
+
+    std::size_t compressed_dbm_t::minimal_constraints_scratch(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim,
+                                                              bool db16, void const * & constraints)
+    {
+      // Compute into a scratch buffer of maximal size, make() only keeps the minimal constraints
+      std::size_t n = 0;
+      if (db16) {
+        static thread_local std::vector<tchecker_ext::dbm_ext::constraint16_t> scratch16;
+        if (scratch16.size() < static_cast<std::size_t>(dim) * dim)
+          scratch16.resize(static_cast<std::size_t>(dim) * dim);
+        n = tchecker_ext::dbm_ext::minimal_constraints(dbm, dim, scratch16.data());
+        constraints = scratch16.data();
+      }
+      else {
+        static thread_local std::vector<tchecker_ext::dbm_ext::constraint_t> scratch;
+        if (scratch.size() < static_cast<std::size_t>(dim) * dim)
+          scratch.resize(static_cast<std::size_t>(dim) * dim);
+        n = tchecker_ext::dbm_ext::minimal_constraints(dbm, dim, scratch.data());
+        constraints = scratch.data();
+      }
+      return n;
+    }
+
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#include <cassert>
+
+#include "tchecker_ext/dbm/db16.hh"
+
+#include <tchecker_ext/config.hh>
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+    bool fits_db16(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim){
+      assert(dbm != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      bool fits = true;
+      // No early exit: the loop is branch free and vectorizes
+      for (std::size_t k = 0; k < size; ++k)
+        fits &= tchecker_ext::dbm_ext::fits_db16(dbm[k]);
+      return fits;
+    } // fits_db16
+
+
+    void to_db16(tchecker_ext::dbm_ext::db16_t * dbm16, tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim){
+      assert(dbm16 != nullptr);
+      assert(dbm != nullptr);
+      assert(tchecker_ext::dbm_ext::fits_db16(dbm, dim));
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k)
+        dbm16[k] = tchecker_ext::dbm_ext::to_db16(dbm[k]);
+    } // to_db16
+
+
+    void to_db(tchecker::dbm::db_t * dbm, tchecker_ext::dbm_ext::db16_t const * dbm16, tchecker::clock_id_t dim){
+      assert(dbm != nullptr);
+      assert(dbm16 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k)
+        dbm[k] = tchecker_ext::dbm_ext::to_db(dbm16[k]);
+    } // to_db
+
+  }
+}
@@ -2,7 +2,12 @@
 // Created by philipp on 02.10.19.
 //
 
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
 #include "tchecker_ext/dbm/dbm.hh"
+#include "tchecker_ext/dbm/simd.hh"
 
 #include <tchecker_ext/config.hh>
 
@@ -13,12 +18,12 @@ namespace tchecker_ext{
 #define DBM1(i,j)         dbm1[(i)*dim1+(j)]
 #define DBM2(i,j)         dbm2[(i)*dim2+(j)]
   
-    enum tchecker::dbm::status_t partial_intersection(tchecker::dbm::db_t * dbm,
-                                              tchecker::dbm::db_t const * dbm1,
-                                              tchecker::dbm::db_t const * dbm2,
-                                              tchecker::clock_id_t dim1,
-                                              tchecker::clock_id_t dim2,
-                                              tchecker::clock_id_t const * idx_clk){
+    enum tchecker::dbm::status_t partial_intersection_scalar(tchecker::dbm::db_t * dbm,
+                                                     tchecker::dbm::db_t const * dbm1,
+                                                     tchecker::dbm::db_t const * dbm2,
+                                                     tchecker::clock_id_t dim1,
+                                                     tchecker::clock_id_t dim2,
+                                                     tchecker::clock_id_t const * idx_clk){
       assert(dim1 >= 1);
       assert(dim2>=dim1);
       assert(dbm != nullptr);
@@ -45,7 +50,144 @@ namespace tchecker_ext{
       } // i
   
       return tchecker::dbm::tighten(dbm, dim1);
+    } // partial_intersection_scalar
+    
+    enum tchecker::dbm::status_t partial_intersection(tchecker::dbm::db_t * dbm,
+                                              tchecker::dbm::db_t const * dbm1,
+                                              tchecker::dbm::db_t const * dbm2,
+                                              tchecker::clock_id_t dim1,
+                                              tchecker::clock_id_t dim2,
+                                              tchecker::clock_id_t const * idx_clk){
+      assert(dim1 >= 1);
+      assert(dim2>=dim1);
+      assert(dbm != nullptr);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(idx_clk != nullptr);
+      assert(tchecker::dbm::is_consistent(dbm1, dim1));
+      assert(tchecker::dbm::is_consistent(dbm2, dim2));
+      assert(tchecker::dbm::is_tight(dbm1, dim1));
+      assert(tchecker::dbm::is_tight(dbm2, dim2));
+      
+      // Entries of dbm2 are read after the entries of dbm before them have been written
+      if (dbm == dbm2){
+        return partial_intersection_scalar(dbm, dbm1, dbm2, dim1, dim2, idx_clk);
+      }
+      tchecker_ext::dbm_ext::partial_min(dbm, dbm1, dbm2, dim1, dim2, idx_clk);
+      return tchecker_ext::dbm_ext::tighten(dbm, dim1);
     } // partial_intersection
     
+#undef DBM
+#undef DBM1
+#undef DBM2
+    
+    bool exact_convex_union(tchecker::dbm::db_t * hull,
+                            tchecker::dbm::db_t * scratch,
+                            tchecker::dbm::db_t const * dbm1,
+                            tchecker::dbm::db_t const * dbm2,
+                            tchecker::clock_id_t dim){
+      assert(dim >= 1);
+      assert(hull != nullptr);
+      assert(scratch != nullptr);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(tchecker::dbm::is_consistent(dbm1, dim));
+      assert(tchecker::dbm::is_consistent(dbm2, dim));
+      assert(tchecker::dbm::is_tight(dbm1, dim));
+      assert(tchecker::dbm::is_tight(dbm2, dim));
+      
+      tchecker::clock_id_t const size = dim * dim;
+      // The entry-wise maximum of two tight dbms is tight
+      for (tchecker::clock_id_t k = 0; k < size; ++k){
+        hull[k] = std::max(dbm1[k], dbm2[k]);
+      }
+      
+      for (tchecker::clock_id_t i = 0; i < dim; ++i){
+        for (tchecker::clock_id_t j = 0; j < dim; ++j){
+          tchecker::dbm::db_t const c = dbm1[i*dim+j];
+          if ((i == j) || (c >= hull[i*dim+j])){
+            continue; // hull satisfies x_i - x_j # c
+          }
+          // Piece: hull and not(x_i - x_j # c), i.e. x_j - x_i #' -c
+          tchecker::dbm::comparator_t const cmp =
+              (tchecker::dbm::comparator(c) == tchecker::dbm::LE ? tchecker::dbm::LT : tchecker::dbm::LE);
+          std::copy(hull, hull + size, scratch);
+          if (tchecker::dbm::constrain(scratch, dim, j, i, cmp, - tchecker::dbm::value(c)) == tchecker::dbm::EMPTY){
+            continue;
+          }
+          if (!tchecker_ext::dbm_ext::is_le(scratch, dbm2, dim)){
+            return false;
+          }
+        } // j
+      } // i
+      return true;
+    } // exact_convex_union
+    
+    bool is_le_union(tchecker::dbm::db_t const * dbm,
+                     tchecker::dbm::db_t const * const * dbms,
+                     std::size_t n,
+                     tchecker::clock_id_t dim,
+                     std::vector<tchecker::dbm::db_t> & pieces,
+                     std::vector<tchecker::dbm::db_t> & next,
+                     std::size_t max_pieces){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+      assert(dbms != nullptr);
+      assert(tchecker::dbm::is_consistent(dbm, dim));
+      assert(tchecker::dbm::is_tight(dbm, dim));
+      
+      std::size_t const size = dim * dim;
+      pieces.assign(dbm, dbm + size);
+      for (std::size_t k = 0; k < n; ++k){
+        tchecker::dbm::db_t const * zone = dbms[k];
+        assert(zone != nullptr);
+        assert(tchecker::dbm::is_consistent(zone, dim));
+        assert(tchecker::dbm::is_tight(zone, dim));
+        next.clear();
+        for (std::size_t p = 0; p < pieces.size(); p += size){
+          // Tight dbms do not meet iff some cycle x_i -> x_j -> x_i through both of them is negative
+          bool disjoint = false;
+          for (tchecker::clock_id_t i = 0; (i < dim) && !disjoint; ++i){
+            for (tchecker::clock_id_t j = 0; (j < dim) && !disjoint; ++j){
+              disjoint = (tchecker::dbm::sum(pieces[p+i*dim+j], zone[j*dim+i]) < tchecker::dbm::LE_ZERO);
+            }
+          }
+          if (disjoint){
+            next.insert(next.end(), pieces.begin() + p, pieces.begin() + p + size);
+            continue;
+          }
+          // The piece is constrained in place by the constraints of zone it does not satisfy
+          tchecker::dbm::db_t * piece = pieces.data() + p;
+          for (tchecker::clock_id_t i = 0; i < dim; ++i){
+            for (tchecker::clock_id_t j = 0; j < dim; ++j){
+              tchecker::dbm::db_t const c = zone[i*dim+j];
+              if ((i == j) || (c >= piece[i*dim+j])){
+                continue;
+              }
+              // piece and not(x_i - x_j # c), i.e. x_j - x_i #' -c
+              tchecker::dbm::comparator_t const cmp =
+                  (tchecker::dbm::comparator(c) == tchecker::dbm::LE ? tchecker::dbm::LT : tchecker::dbm::LE);
+              std::size_t const offset = next.size();
+              next.insert(next.end(), piece, piece + size);
+              if (tchecker::dbm::constrain(next.data() + offset, dim, j, i, cmp, - tchecker::dbm::value(c))
+                  == tchecker::dbm::EMPTY){
+                next.resize(offset);
+              }
+              // piece meets zone, hence it still does once constrained by c
+              tchecker::dbm::constrain(piece, dim, i, j, tchecker::dbm::comparator(c), tchecker::dbm::value(c));
+            } // j
+          } // i
+          if (next.size() > max_pieces * size){
+            return false;
+          }
+        } // p
+        pieces.swap(next);
+        if (pieces.empty()){
+          return true;
+        }
+      } // k
+      return pieces.empty();
+    } // is_le_union
+    
   }
 }
\ No newline at end of file
@@ -0,0 +1,699 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "tchecker_ext/dbm/simd.hh"
+
+#include <tchecker_ext/config.hh>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TCHECKER_EXT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace tchecker_ext{
+  namespace dbm_ext{
+
+    static_assert(std::is_same<tchecker::dbm::db_t, std::int32_t>::value, "kernels compare 32 bits bounds");
+    static_assert(std::is_same<tchecker::integer_t, std::int32_t>::value, "kernels load 32 bits clock bounds");
+
+#define DBM1(i,j)         dbm1[(i)*dim+(j)]
+#define DBM2(i,j)         dbm2[(i)*dim+(j)]
+
+    bool is_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k){
+        if (dbm1[k] > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_scalar
+
+
+    bool is_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2,
+                      tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k){
+        if (dbm1[k] > tchecker_ext::dbm_ext::to_db(dbm2[k])){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_scalar
+
+
+    bool is_le_scalar(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2,
+                      tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k){
+        if (tchecker_ext::dbm_ext::to_db(dbm1[k]) > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_scalar
+
+
+    /*!
+     \brief Violation of the aLU inclusion by an entry of row y
+     \pre l[y] >= 0
+     \return true if x and y witness that dbm1 is not included in aLU(dbm2), false otherwise
+     */
+    static inline bool alu_violation(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2,
+                                     tchecker::clock_id_t dim, tchecker::integer_t const * l,
+                                     tchecker::integer_t const * u, tchecker::clock_id_t x, tchecker::clock_id_t y){
+      // dbm1[0,x] >= (<=,-U_x)
+      if ((u[x] < 0) || (DBM1(0,x) < tchecker::dbm::db(tchecker::dbm::LE, -u[x]))){
+        return false;
+      }
+      tchecker::dbm::db_t const d2 = DBM2(y,x);
+      if ((d2 >= DBM1(y,x)) || (d2 == tchecker::dbm::LT_INFINITY)){
+        return false;
+      }
+      // dbm2[y,x] + (<,-L_y) is (<, value(dbm2[y,x]) - L_y)
+      return ((d2 & ~1) - 2 * l[y] < DBM1(0,x));
+    } // alu_violation
+
+
+    bool is_alu_le_scalar(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                          tchecker::integer_t const * l, tchecker::integer_t const * u){
+      assert(dim >= 1);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(l != nullptr);
+      assert(u != nullptr);
+
+      for (tchecker::clock_id_t y = 0; y < dim; ++y){
+        if (l[y] < 0){
+          continue; // no lower bound, (<,-L_y) is -infinity
+        }
+        for (tchecker::clock_id_t x = 0; x < dim; ++x){
+          if (alu_violation(dbm1, dbm2, dim, l, u, x, y)){
+            return false;
+          }
+        }
+      }
+      return true;
+    } // is_alu_le_scalar
+
+
+#define DBM(i,j)          dbm[(i)*dim+(j)]
+
+    enum tchecker::dbm::status_t tighten_scalar(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim){
+      return tchecker::dbm::tighten(dbm, dim);
+    } // tighten_scalar
+
+
+    /*!
+     \brief Scalar update of row i of a dbm through clock k, as in tchecker::dbm::tighten()
+     */
+    static inline void tighten_row(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim,
+                                   tchecker::clock_id_t i, tchecker::clock_id_t k, tchecker::clock_id_t from){
+      for (tchecker::clock_id_t j = from; j < dim; ++j){
+        DBM(i,j) = tchecker::dbm::min(DBM(i,j), tchecker::dbm::sum(DBM(i,k), DBM(k,j)));
+      }
+    } // tighten_row
+
+
+    void partial_min_scalar(tchecker::dbm::db_t * dbm,
+                            tchecker::dbm::db_t const * dbm1,
+                            tchecker::dbm::db_t const * dbm2,
+                            tchecker::clock_id_t dim1,
+                            tchecker::clock_id_t dim2,
+                            tchecker::clock_id_t const * idx_clk){
+      assert(dim1 >= 1);
+      assert(dim2 >= dim1);
+      assert(dbm != nullptr);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(idx_clk != nullptr);
+
+      for (tchecker::clock_id_t i = 0; i < dim1; ++i){
+        tchecker::dbm::db_t const * row2 = dbm2 + idx_clk[i] * dim2;
+        for (tchecker::clock_id_t j = 0; j < dim1; ++j){
+          dbm[i*dim1+j] = tchecker::dbm::min(dbm1[i*dim1+j], row2[idx_clk[j]]);
+        }
+      }
+    } // partial_min_scalar
+
+
+#if defined(TCHECKER_EXT_SIMD_X86)
+
+    __attribute__((target("sse4.1")))
+    static bool is_le_sse4(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 4 <= size; k += 4){
+        __m128i const gt = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm1 + k)),
+                                           _mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm2 + k)));
+        if (!_mm_testz_si128(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (dbm1[k] > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_sse4
+
+
+    __attribute__((target("avx2")))
+    static bool is_le_avx2(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 8 <= size; k += 8){
+        __m256i const gt = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm1 + k)),
+                                              _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm2 + k)));
+        if (!_mm256_testz_si256(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (dbm1[k] > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_avx2
+
+
+    /*!
+     \brief Encoding of 8 bounds on 16 bits
+     \param lo : bounds 0 to 3
+     \param hi : bounds 4 to 7
+     \return the 8 bounds on 16 bits: infinity as LT_INFINITY16, finite bounds saturated to
+     [-32768, LT_INFINITY16 - 1]
+     */
+    __attribute__((target("sse4.1")))
+    static inline __m128i narrow_sse4(__m128i lo, __m128i hi){
+      __m128i const infinity = _mm_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m128i const narrow = _mm_min_epi16(_mm_packs_epi32(lo, hi), _mm_set1_epi16(LT_INFINITY16 - 1));
+      __m128i const is_infinity = _mm_packs_epi32(_mm_cmpeq_epi32(lo, infinity), _mm_cmpeq_epi32(hi, infinity));
+      return _mm_blendv_epi8(narrow, _mm_set1_epi16(LT_INFINITY16), is_infinity);
+    } // narrow_sse4
+
+
+    /*!
+     \brief Encoding of 16 bounds on 16 bits
+     \param lo : bounds 0 to 7
+     \param hi : bounds 8 to 15
+     \return see narrow_sse4()
+     \note _mm256_packs_epi32 interleaves the 128 bits lanes of lo and hi, the permutation restores the order
+     */
+    __attribute__((target("avx2")))
+    static inline __m256i narrow_avx2(__m256i lo, __m256i hi){
+      __m256i const infinity = _mm256_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m256i const narrow = _mm256_min_epi16(_mm256_packs_epi32(lo, hi), _mm256_set1_epi16(LT_INFINITY16 - 1));
+      __m256i const is_infinity = _mm256_packs_epi32(_mm256_cmpeq_epi32(lo, infinity), _mm256_cmpeq_epi32(hi, infinity));
+      return _mm256_permute4x64_epi64(_mm256_blendv_epi8(narrow, _mm256_set1_epi16(LT_INFINITY16), is_infinity), 0xD8);
+    } // narrow_avx2
+
+
+    __attribute__((target("sse4.1")))
+    static bool is_le_db16_sse4(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2,
+                                tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 8 <= size; k += 8){
+        __m128i const d1 = narrow_sse4(_mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm1 + k)),
+                                       _mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm1 + k + 4)));
+        __m128i const gt = _mm_cmpgt_epi16(d1, _mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm2 + k)));
+        if (!_mm_testz_si128(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (dbm1[k] > tchecker_ext::dbm_ext::to_db(dbm2[k])){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_db16_sse4
+
+
+    __attribute__((target("sse4.1")))
+    static bool is_le_of_db16_sse4(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2,
+                                   tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 8 <= size; k += 8){
+        __m128i const d2 = narrow_sse4(_mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm2 + k)),
+                                       _mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm2 + k + 4)));
+        __m128i const gt = _mm_cmpgt_epi16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm1 + k)), d2);
+        if (!_mm_testz_si128(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (tchecker_ext::dbm_ext::to_db(dbm1[k]) > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_of_db16_sse4
+
+
+    __attribute__((target("avx2")))
+    static bool is_le_db16_avx2(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2,
+                                tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 16 <= size; k += 16){
+        __m256i const d1 = narrow_avx2(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm1 + k)),
+                                       _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm1 + k + 8)));
+        __m256i const gt = _mm256_cmpgt_epi16(d1, _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm2 + k)));
+        if (!_mm256_testz_si256(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (dbm1[k] > tchecker_ext::dbm_ext::to_db(dbm2[k])){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_db16_avx2
+
+
+    __attribute__((target("avx2")))
+    static bool is_le_of_db16_avx2(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2,
+                                   tchecker::clock_id_t dim){
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      std::size_t k = 0;
+      for ( ; k + 16 <= size; k += 16){
+        __m256i const d2 = narrow_avx2(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm2 + k)),
+                                       _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm2 + k + 8)));
+        __m256i const gt = _mm256_cmpgt_epi16(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm1 + k)), d2);
+        if (!_mm256_testz_si256(gt, gt)){
+          return false;
+        }
+      }
+      for ( ; k < size; ++k){
+        if (tchecker_ext::dbm_ext::to_db(dbm1[k]) > dbm2[k]){
+          return false;
+        }
+      }
+      return true;
+    } // is_le_of_db16_avx2
+
+
+    __attribute__((target("sse4.1")))
+    static bool is_alu_le_sse4(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                               tchecker::integer_t const * l, tchecker::integer_t const * u){
+      assert(dim >= 1);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(l != nullptr);
+      assert(u != nullptr);
+
+      __m128i const minus_one = _mm_set1_epi32(-1);
+      __m128i const infinity = _mm_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m128i const value_mask = _mm_set1_epi32(~1);
+      for (tchecker::clock_id_t y = 0; y < dim; ++y){
+        if (l[y] < 0){
+          continue;
+        }
+        __m128i const two_ly = _mm_set1_epi32(2 * l[y]);
+        tchecker::clock_id_t x = 0;
+        for ( ; x + 4 <= dim; x += 4){
+          __m128i const d1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&DBM1(y,x)));
+          __m128i const d2 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&DBM2(y,x)));
+          __m128i const z0x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&DBM1(0,x)));
+          __m128i const ux = _mm_loadu_si128(reinterpret_cast<__m128i const *>(u + x));
+          // dbm1[0,x] >= (<=,-U_x), i.e. dbm1[0,x] > -2 * U_x
+          __m128i m = _mm_and_si128(_mm_cmpgt_epi32(ux, minus_one),
+                                       _mm_cmpgt_epi32(z0x, _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(ux, ux))));
+          // dbm2[y,x] < dbm1[y,x], dbm2[y,x] finite
+          m = _mm_and_si128(m, _mm_cmpgt_epi32(d1, d2));
+          m = _mm_andnot_si128(_mm_cmpeq_epi32(d2, infinity), m);
+          // dbm2[y,x] + (<,-L_y) < dbm1[0,x]
+          m = _mm_and_si128(m, _mm_cmpgt_epi32(z0x, _mm_sub_epi32(_mm_and_si128(d2, value_mask), two_ly)));
+          if (!_mm_testz_si128(m, m)){
+            return false;
+          }
+        }
+        for ( ; x < dim; ++x){
+          if (alu_violation(dbm1, dbm2, dim, l, u, x, y)){
+            return false;
+          }
+        }
+      }
+      return true;
+    } // is_alu_le_sse4
+
+
+    __attribute__((target("avx2")))
+    static bool is_alu_le_avx2(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                               tchecker::integer_t const * l, tchecker::integer_t const * u){
+      assert(dim >= 1);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(l != nullptr);
+      assert(u != nullptr);
+
+      __m256i const minus_one = _mm256_set1_epi32(-1);
+      __m256i const infinity = _mm256_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m256i const value_mask = _mm256_set1_epi32(~1);
+      for (tchecker::clock_id_t y = 0; y < dim; ++y){
+        if (l[y] < 0){
+          continue;
+        }
+        __m256i const two_ly = _mm256_set1_epi32(2 * l[y]);
+        tchecker::clock_id_t x = 0;
+        for ( ; x + 8 <= dim; x += 8){
+          __m256i const d1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&DBM1(y,x)));
+          __m256i const d2 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&DBM2(y,x)));
+          __m256i const z0x = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&DBM1(0,x)));
+          __m256i const ux = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(u + x));
+          // dbm1[0,x] >= (<=,-U_x), i.e. dbm1[0,x] > -2 * U_x
+          __m256i m = _mm256_and_si256(_mm256_cmpgt_epi32(ux, minus_one),
+                                       _mm256_cmpgt_epi32(z0x, _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_add_epi32(ux, ux))));
+          // dbm2[y,x] < dbm1[y,x], dbm2[y,x] finite
+          m = _mm256_and_si256(m, _mm256_cmpgt_epi32(d1, d2));
+          m = _mm256_andnot_si256(_mm256_cmpeq_epi32(d2, infinity), m);
+          // dbm2[y,x] + (<,-L_y) < dbm1[0,x]
+          m = _mm256_and_si256(m, _mm256_cmpgt_epi32(z0x, _mm256_sub_epi32(_mm256_and_si256(d2, value_mask), two_ly)));
+          if (!_mm256_testz_si256(m, m)){
+            return false;
+          }
+        }
+        for ( ; x < dim; ++x){
+          if (alu_violation(dbm1, dbm2, dim, l, u, x, y)){
+            return false;
+          }
+        }
+      }
+      return true;
+    } // is_alu_le_avx2
+
+    // The sum of finite bounds a and b is (value(a) + value(b)) << 1 | (comparator(a) & comparator(b)),
+    // i.e. ((a & ~1) + (b & ~1)) | (a & b & 1). It is < infinity if a or b is < infinity
+
+    __attribute__((target("sse4.1")))
+    static enum tchecker::dbm::status_t tighten_sse4(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+
+      __m128i const infinity = _mm_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m128i const value_mask = _mm_set1_epi32(~1);
+      for (tchecker::clock_id_t k = 0; k < dim; ++k){
+        // dbm(i,k) does not change within row i as long as dbm(k,k) is (<=,0)
+        bool const broadcast = (DBM(k,k) == tchecker::dbm::LE_ZERO);
+        for (tchecker::clock_id_t i = 0; i < dim; ++i){
+          if ((i == k) || (DBM(i,k) == tchecker::dbm::LT_INFINITY)){
+            continue;
+          }
+          tchecker::clock_id_t j = 0;
+          if (broadcast){
+            __m128i const ik_value = _mm_set1_epi32(DBM(i,k) & ~1);
+            __m128i const ik_cmp = _mm_set1_epi32(DBM(i,k) & 1);
+            for ( ; j + 4 <= dim; j += 4){
+              __m128i const kj = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&DBM(k,j)));
+              __m128i const ij = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&DBM(i,j)));
+              __m128i sum = _mm_or_si128(_mm_add_epi32(_mm_and_si128(kj, value_mask), ik_value), _mm_and_si128(kj, ik_cmp));
+              sum = _mm_blendv_epi8(sum, infinity, _mm_cmpeq_epi32(kj, infinity));
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(&DBM(i,j)), _mm_min_epi32(ij, sum));
+            }
+          }
+          tighten_row(dbm, dim, i, k, j);
+          if (DBM(i,i) < tchecker::dbm::LE_ZERO){
+            DBM(0,0) = tchecker::dbm::LT_ZERO;
+            return tchecker::dbm::EMPTY;
+          }
+        }
+      }
+      return tchecker::dbm::NON_EMPTY;
+    } // tighten_sse4
+
+
+    __attribute__((target("avx2")))
+    static enum tchecker::dbm::status_t tighten_avx2(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim){
+      assert(dim >= 1);
+      assert(dbm != nullptr);
+
+      __m256i const infinity = _mm256_set1_epi32(tchecker::dbm::LT_INFINITY);
+      __m256i const value_mask = _mm256_set1_epi32(~1);
+      for (tchecker::clock_id_t k = 0; k < dim; ++k){
+        // dbm(i,k) does not change within row i as long as dbm(k,k) is (<=,0)
+        bool const broadcast = (DBM(k,k) == tchecker::dbm::LE_ZERO);
+        for (tchecker::clock_id_t i = 0; i < dim; ++i){
+          if ((i == k) || (DBM(i,k) == tchecker::dbm::LT_INFINITY)){
+            continue;
+          }
+          tchecker::clock_id_t j = 0;
+          if (broadcast){
+            __m256i const ik_value = _mm256_set1_epi32(DBM(i,k) & ~1);
+            __m256i const ik_cmp = _mm256_set1_epi32(DBM(i,k) & 1);
+            for ( ; j + 8 <= dim; j += 8){
+              __m256i const kj = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&DBM(k,j)));
+              __m256i const ij = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(&DBM(i,j)));
+              __m256i sum = _mm256_or_si256(_mm256_add_epi32(_mm256_and_si256(kj, value_mask), ik_value),
+                                            _mm256_and_si256(kj, ik_cmp));
+              sum = _mm256_blendv_epi8(sum, infinity, _mm256_cmpeq_epi32(kj, infinity));
+              _mm256_storeu_si256(reinterpret_cast<__m256i *>(&DBM(i,j)), _mm256_min_epi32(ij, sum));
+            }
+          }
+          tighten_row(dbm, dim, i, k, j);
+          if (DBM(i,i) < tchecker::dbm::LE_ZERO){
+            DBM(0,0) = tchecker::dbm::LT_ZERO;
+            return tchecker::dbm::EMPTY;
+          }
+        }
+      }
+      return tchecker::dbm::NON_EMPTY;
+    } // tighten_avx2
+
+
+    __attribute__((target("sse4.1")))
+    static void partial_min_sse4(tchecker::dbm::db_t * dbm,
+                                 tchecker::dbm::db_t const * dbm1,
+                                 tchecker::dbm::db_t const * dbm2,
+                                 tchecker::clock_id_t dim1,
+                                 tchecker::clock_id_t dim2,
+                                 tchecker::clock_id_t const * idx_clk){
+      assert(dim1 >= 1);
+      assert(dim2 >= dim1);
+      assert(dbm != nullptr);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(idx_clk != nullptr);
+
+      for (tchecker::clock_id_t i = 0; i < dim1; ++i){
+        tchecker::dbm::db_t const * row2 = dbm2 + idx_clk[i] * dim2;
+        tchecker::clock_id_t j = 0;
+        for ( ; j + 4 <= dim1; j += 4){
+          __m128i const d2 = _mm_set_epi32(row2[idx_clk[j+3]], row2[idx_clk[j+2]], row2[idx_clk[j+1]], row2[idx_clk[j]]);
+          __m128i const d1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dbm1 + i * dim1 + j));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dbm + i * dim1 + j), _mm_min_epi32(d1, d2));
+        }
+        for ( ; j < dim1; ++j){
+          dbm[i*dim1+j] = tchecker::dbm::min(dbm1[i*dim1+j], row2[idx_clk[j]]);
+        }
+      }
+    } // partial_min_sse4
+
+
+    __attribute__((target("avx2")))
+    static void partial_min_avx2(tchecker::dbm::db_t * dbm,
+                                 tchecker::dbm::db_t const * dbm1,
+                                 tchecker::dbm::db_t const * dbm2,
+                                 tchecker::clock_id_t dim1,
+                                 tchecker::clock_id_t dim2,
+                                 tchecker::clock_id_t const * idx_clk){
+      assert(dim1 >= 1);
+      assert(dim2 >= dim1);
+      assert(dbm != nullptr);
+      assert(dbm1 != nullptr);
+      assert(dbm2 != nullptr);
+      assert(idx_clk != nullptr);
+
+      for (tchecker::clock_id_t i = 0; i < dim1; ++i){
+        tchecker::dbm::db_t const * row2 = dbm2 + idx_clk[i] * dim2;
+        tchecker::clock_id_t j = 0;
+        for ( ; j + 8 <= dim1; j += 8){
+          __m256i const idx = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(idx_clk + j));
+          __m256i const d2 = _mm256_i32gather_epi32(reinterpret_cast<int const *>(row2), idx, 4);
+          __m256i const d1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(dbm1 + i * dim1 + j));
+          _mm256_storeu_si256(reinterpret_cast<__m256i *>(dbm + i * dim1 + j), _mm256_min_epi32(d1, d2));
+        }
+        for ( ; j < dim1; ++j){
+          dbm[i*dim1+j] = tchecker::dbm::min(dbm1[i*dim1+j], row2[idx_clk[j]]);
+        }
+      }
+    } // partial_min_avx2
+
+#endif // TCHECKER_EXT_SIMD_X86
+
+#undef DBM
+#undef DBM1
+#undef DBM2
+
+
+    /*!
+     \class kernels_t
+     \brief Kernels selected for the running CPU
+     */
+    struct kernels_t {
+      enum tchecker_ext::dbm_ext::simd_level_t level;
+      bool (*is_le)(tchecker::dbm::db_t const *, tchecker::dbm::db_t const *, tchecker::clock_id_t);
+      bool (*is_le_db16)(tchecker::dbm::db_t const *, tchecker_ext::dbm_ext::db16_t const *, tchecker::clock_id_t);
+      bool (*is_le_of_db16)(tchecker_ext::dbm_ext::db16_t const *, tchecker::dbm::db_t const *, tchecker::clock_id_t);
+      bool (*is_alu_le)(tchecker::dbm::db_t const *, tchecker::dbm::db_t const *, tchecker::clock_id_t,
+                        tchecker::integer_t const *, tchecker::integer_t const *);
+      enum tchecker::dbm::status_t (*tighten)(tchecker::dbm::db_t *, tchecker::clock_id_t);
+      void (*partial_min)(tchecker::dbm::db_t *, tchecker::dbm::db_t const *, tchecker::dbm::db_t const *,
+                          tchecker::clock_id_t, tchecker::clock_id_t, tchecker::clock_id_t const *);
+    };
+
+
+    /*!
+     \brief Kernel selection
+     \return the kernels of the widest instruction set supported by the running CPU
+     */
+    static tchecker_ext::dbm_ext::kernels_t select_kernels(){
+#if defined(TCHECKER_EXT_SIMD_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")){
+        return kernels_t{SIMD_AVX2, &is_le_avx2, &is_le_db16_avx2, &is_le_of_db16_avx2, &is_alu_le_avx2, &tighten_avx2,
+                         &partial_min_avx2};
+      }
+      if (__builtin_cpu_supports("sse4.1")){
+        return kernels_t{SIMD_SSE4, &is_le_sse4, &is_le_db16_sse4, &is_le_of_db16_sse4, &is_alu_le_sse4, &tighten_sse4,
+                         &partial_min_sse4};
+      }
+#endif
+      return kernels_t{SIMD_SCALAR, &is_le_scalar, &is_le_scalar, &is_le_scalar, &is_alu_le_scalar, &tighten_scalar,
+                       &partial_min_scalar};
+    } // select_kernels
+
+
+    static inline tchecker_ext::dbm_ext::kernels_t const & kernels(){
+      static tchecker_ext::dbm_ext::kernels_t const selected = select_kernels();
+      return selected;
+    } // kernels
+
+
+    enum tchecker_ext::dbm_ext::simd_level_t simd_level(){
+      return kernels().level;
+    } // simd_level
+
+
+    char const * simd_level_name(enum tchecker_ext::dbm_ext::simd_level_t level){
+      switch (level){
+        case SIMD_AVX2:
+          return "avx2";
+        case SIMD_SSE4:
+          return "sse4.1";
+        default:
+          return "scalar";
+      }
+    } // simd_level_name
+
+
+    bool is_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim){
+      return kernels().is_le(dbm1, dbm2, dim);
+    } // is_le
+
+
+    bool is_le(tchecker::dbm::db_t const * dbm1, tchecker_ext::dbm_ext::db16_t const * dbm2, tchecker::clock_id_t dim){
+      return kernels().is_le_db16(dbm1, dbm2, dim);
+    } // is_le
+
+
+    bool is_le(tchecker_ext::dbm_ext::db16_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim){
+      return kernels().is_le_of_db16(dbm1, dbm2, dim);
+    } // is_le
+
+
+    bool is_alu_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                   tchecker::integer_t const * l, tchecker::integer_t const * u){
+      return kernels().is_alu_le(dbm1, dbm2, dim, l, u);
+    } // is_alu_le
+
+
+    bool is_am_le(tchecker::dbm::db_t const * dbm1, tchecker::dbm::db_t const * dbm2, tchecker::clock_id_t dim,
+                  tchecker::integer_t const * m){
+      return kernels().is_alu_le(dbm1, dbm2, dim, m, m);
+    } // is_am_le
+
+
+    /*!
+     \brief Bound on the sums of tighten()
+     \param dbm : a dbm
+     \param dim : dimension of dbm
+     \return true if no sum computed by tighten() on dbm can overflow, false otherwise
+     \note every bound computed by Floyd-Warshall is infinity or the value of a path of at most dim-1
+     finite bounds, a sum adds two of them. Hence sums are within (-INF_VALUE, INF_VALUE) if
+     2 * dim * max |value| < INF_VALUE
+     */
+    static bool sums_are_bounded(tchecker::dbm::db_t const * dbm, tchecker::clock_id_t dim){
+      std::int64_t max_value = 0;
+      std::size_t const size = static_cast<std::size_t>(dim) * dim;
+      for (std::size_t k = 0; k < size; ++k){
+        if (dbm[k] != tchecker::dbm::LT_INFINITY){
+          std::int64_t const v = tchecker::dbm::value(dbm[k]);
+          max_value = std::max(max_value, (v < 0 ? -v : v));
+        }
+      }
+      return 2 * static_cast<std::int64_t>(dim) * max_value < tchecker::dbm::INF_VALUE;
+    } // sums_are_bounded
+
+
+    enum tchecker::dbm::status_t tighten(tchecker::dbm::db_t * dbm, tchecker::clock_id_t dim){
+      // The vector sums are not checked, tchecker::dbm::sum() checks the others
+      if ((kernels().level != SIMD_SCALAR) && !sums_are_bounded(dbm, dim)){
+        return tighten_scalar(dbm, dim);
+      }
+      return kernels().tighten(dbm, dim);
+    } // tighten
+
+
+    void partial_min(tchecker::dbm::db_t * dbm,
+                     tchecker::dbm::db_t const * dbm1,
+                     tchecker::dbm::db_t const * dbm2,
+                     tchecker::clock_id_t dim1,
+                     tchecker::clock_id_t dim2,
+                     tchecker::clock_id_t const * idx_clk){
+      kernels().partial_min(dbm, dbm1, dbm2, dim1, dim2, idx_clk);
+    } // partial_min
+
+  }
+}
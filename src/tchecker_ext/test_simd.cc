@@ -0,0 +1,253 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "tchecker/dbm/dbm.hh"
+
+#include "tchecker_ext/dbm/simd.hh"
+
+/*!
+ \file test_simd.cc
+ \brief Randomized equivalence checks of the kernels of tchecker_ext::dbm_ext against the kernels of
+ tchecker::dbm and the scalar kernels, with the kernels selected for the running CPU
+ \note usage: test_simd [seed]. Exits with status 1 if a kernel disagrees
+ */
+
+using db_t = tchecker::dbm::db_t;
+
+static std::mt19937 rnd;
+
+/*!
+ \brief Random dbm, not tight
+ \post dbm is a dim*dim array of difference bounds with diagonal (<=,0) and first row (<=,0), other
+ entries are infinity or random bounds in [-8,12] (in [-range, range] with a large range)
+ */
+static void random_raw(std::vector<db_t> & dbm, tchecker::clock_id_t dim, tchecker::integer_t range=0)
+{
+  dbm.assign(dim * dim, tchecker::dbm::LT_INFINITY);
+  for (tchecker::clock_id_t i = 0; i < dim; ++i) {
+    dbm[i * dim + i] = tchecker::dbm::LE_ZERO;
+    dbm[i] = tchecker::dbm::LE_ZERO;
+  }
+  for (tchecker::clock_id_t i = 1; i < dim; ++i)
+    for (tchecker::clock_id_t j = 0; j < dim; ++j) {
+      if ((i == j) || (rnd() % 3 != 0))
+        continue;
+      tchecker::integer_t const v = (range == 0 ? static_cast<tchecker::integer_t>(rnd() % 21) - 8 :
+                                     static_cast<tchecker::integer_t>(rnd() % (2 * range + 1)) - range);
+      dbm[i * dim + j] = tchecker::dbm::db((rnd() % 2 == 0 ? tchecker::dbm::LT : tchecker::dbm::LE), v);
+    }
+}
+
+/*!
+ \brief Random zone
+ \return true if dbm is a tight non-empty dbm, false otherwise
+ */
+static bool random_zone(std::vector<db_t> & dbm, tchecker::clock_id_t dim)
+{
+  random_raw(dbm, dim);
+  return (tchecker::dbm::tighten(dbm.data(), dim) == tchecker::dbm::NON_EMPTY);
+}
+
+/*!
+ \brief Fixed aLU cases
+ \return number of disagreements with tchecker::dbm::is_alu_le()
+ \note Z = {x = 10} is included in aLU({x = 7}) for L_x = U_x = 5: both valuations are above the bounds
+ */
+static unsigned long check_alu_cases()
+{
+  tchecker::clock_id_t const dim = 2;
+  std::vector<db_t> z1(dim * dim), z2(dim * dim);
+  tchecker::dbm::universal_positive(z1.data(), dim);
+  tchecker::dbm::universal_positive(z2.data(), dim);
+  z1[0 * dim + 1] = tchecker::dbm::db(tchecker::dbm::LE, -10);
+  z1[1 * dim + 0] = tchecker::dbm::db(tchecker::dbm::LE, 10);
+  z2[0 * dim + 1] = tchecker::dbm::db(tchecker::dbm::LE, -7);
+  z2[1 * dim + 0] = tchecker::dbm::db(tchecker::dbm::LE, 7);
+  tchecker::integer_t const bounds[dim] = {0, 5};
+  unsigned long bad = 0;
+  for (auto const & [dbm1, dbm2] : {std::make_pair(&z1, &z2), std::make_pair(&z2, &z1)}) {
+    bool const alu_le = tchecker::dbm::is_alu_le(dbm1->data(), dbm2->data(), dim, bounds, bounds);
+    if ((tchecker_ext::dbm_ext::is_alu_le(dbm1->data(), dbm2->data(), dim, bounds, bounds) != alu_le) ||
+        (tchecker_ext::dbm_ext::is_alu_le_scalar(dbm1->data(), dbm2->data(), dim, bounds, bounds) != alu_le) ||
+        !alu_le)
+      ++bad;
+  }
+  return bad;
+}
+
+/*!
+ \brief Inclusion checks
+ \return number of disagreements
+ */
+static unsigned long check_inclusion(unsigned long rounds)
+{
+  unsigned long bad = 0;
+  std::vector<db_t> dbm1, dbm2;
+  for (unsigned long r = 0; r < rounds; ++r) {
+    tchecker::clock_id_t const dim = 1 + rnd() % 20;
+    if (!random_zone(dbm1, dim) || !random_zone(dbm2, dim))
+      continue;
+    if (rnd() % 3 == 0) // dbm1 included in dbm2
+      for (std::size_t k = 0; k < dbm2.size(); ++k)
+        dbm2[k] = std::max(dbm1[k], dbm2[k]);
+    std::vector<tchecker::integer_t> l(dim, 0), u(dim, 0);
+    for (tchecker::clock_id_t x = 1; x < dim; ++x) {
+      l[x] = static_cast<tchecker::integer_t>(rnd() % 10) - 2;
+      u[x] = static_cast<tchecker::integer_t>(rnd() % 10) - 2;
+    }
+    bool const le = tchecker::dbm::is_le(dbm1.data(), dbm2.data(), dim);
+    if ((tchecker_ext::dbm_ext::is_le(dbm1.data(), dbm2.data(), dim) != le) ||
+        (tchecker_ext::dbm_ext::is_le_scalar(dbm1.data(), dbm2.data(), dim) != le))
+      ++bad;
+    bool const alu_le = tchecker::dbm::is_alu_le(dbm1.data(), dbm2.data(), dim, l.data(), u.data());
+    if ((tchecker_ext::dbm_ext::is_alu_le(dbm1.data(), dbm2.data(), dim, l.data(), u.data()) != alu_le) ||
+        (tchecker_ext::dbm_ext::is_alu_le_scalar(dbm1.data(), dbm2.data(), dim, l.data(), u.data()) != alu_le) ||
+        (le && !alu_le))
+      ++bad;
+    bool const am_le = tchecker::dbm::is_am_le(dbm1.data(), dbm2.data(), dim, l.data());
+    if (tchecker_ext::dbm_ext::is_am_le(dbm1.data(), dbm2.data(), dim, l.data()) != am_le)
+      ++bad;
+  }
+  return bad;
+}
+
+/*!
+ \brief Inclusion checks with a 16 bits dbm
+ \return number of disagreements with tchecker::dbm::is_le() on the decoded dbm
+ \note the 32 bits dbm has bounds beyond 16 bits every other round, they are saturated by the kernels
+ */
+static unsigned long check_db16(unsigned long rounds)
+{
+  unsigned long bad = 0;
+  std::vector<db_t> dbm1, dbm2, decoded;
+  std::vector<tchecker_ext::dbm_ext::db16_t> dbm16;
+  for (unsigned long r = 0; r < rounds; ++r) {
+    tchecker::clock_id_t const dim = 1 + rnd() % 20;
+    if (!random_zone(dbm2, dim))
+      continue;
+    random_raw(dbm1, dim, (r % 2 == 0 ? tchecker::dbm::INF_VALUE / 4 : 0));
+    if (rnd() % 3 == 0) // bounds next to the 16 bits bounds
+      for (std::size_t k = 0; k < dbm1.size(); ++k)
+        if (dbm2[k] != tchecker::dbm::LT_INFINITY)
+          dbm1[k] = dbm2[k] + static_cast<db_t>(rnd() % 3) - 1;
+    bool const limits = (rnd() % 4 == 0);
+    if (limits) // bounds at the limits of 16 bits, dbm2 is not tight anymore
+      for (std::size_t k = 0; k < dbm2.size(); ++k)
+        if (rnd() % 4 == 0)
+          dbm2[k] = (rnd() % 2 == 0 ? tchecker_ext::dbm_ext::DB16_MAX : tchecker_ext::dbm_ext::DB16_MIN);
+    dbm16.resize(dim * dim);
+    decoded.resize(dim * dim);
+    tchecker_ext::dbm_ext::to_db16(dbm16.data(), dbm2.data(), dim);
+    tchecker_ext::dbm_ext::to_db(decoded.data(), dbm16.data(), dim);
+    if (decoded != dbm2)
+      ++bad;
+    // Entry-wise comparisons, dbm1 is not tight
+    bool const le = tchecker_ext::dbm_ext::is_le_scalar(dbm1.data(), decoded.data(), dim);
+    bool const ge = tchecker_ext::dbm_ext::is_le_scalar(decoded.data(), dbm1.data(), dim);
+    if ((tchecker_ext::dbm_ext::is_le(dbm1.data(), dbm16.data(), dim) != le) ||
+        (tchecker_ext::dbm_ext::is_le_scalar(dbm1.data(), dbm16.data(), dim) != le) ||
+        (tchecker_ext::dbm_ext::is_le(dbm16.data(), dbm1.data(), dim) != ge) ||
+        (tchecker_ext::dbm_ext::is_le_scalar(dbm16.data(), dbm1.data(), dim) != ge))
+      ++bad;
+    // Tight dbms
+    if (!limits && random_zone(dbm1, dim) &&
+        ((tchecker_ext::dbm_ext::is_le(dbm1.data(), dbm16.data(), dim) !=
+          tchecker::dbm::is_le(dbm1.data(), decoded.data(), dim)) ||
+         (tchecker_ext::dbm_ext::is_le(dbm16.data(), dbm1.data(), dim) !=
+          tchecker::dbm::is_le(decoded.data(), dbm1.data(), dim))))
+      ++bad;
+  }
+  return bad;
+}
+
+/*!
+ \brief Tightening checks, with small and large bounds (the latter take the checked path)
+ \return number of disagreements
+ */
+static unsigned long check_tighten(unsigned long rounds)
+{
+  unsigned long bad = 0;
+  std::vector<db_t> dbm1, dbm2;
+  for (unsigned long r = 0; r < rounds; ++r) {
+    tchecker::clock_id_t const dim = 1 + rnd() % 20;
+    random_raw(dbm1, dim, (r % 4 == 0 ? tchecker::dbm::INF_VALUE / 4 : 0));
+    dbm2 = dbm1;
+    bool thrown1 = false, thrown2 = false;
+    enum tchecker::dbm::status_t status1 = tchecker::dbm::NON_EMPTY, status2 = tchecker::dbm::NON_EMPTY;
+    try {
+      status1 = tchecker::dbm::tighten(dbm1.data(), dim);
+    }
+    catch (...) {
+      thrown1 = true;
+    }
+    try {
+      status2 = tchecker_ext::dbm_ext::tighten(dbm2.data(), dim);
+    }
+    catch (...) {
+      thrown2 = true;
+    }
+    if ((thrown1 != thrown2) || (!thrown1 && ((status1 != status2) || (dbm1 != dbm2))))
+      ++bad;
+  }
+  return bad;
+}
+
+/*!
+ \brief Partial minimum checks
+ \return number of disagreements
+ */
+static unsigned long check_partial_min(unsigned long rounds)
+{
+  unsigned long bad = 0;
+  std::vector<db_t> dbm1, dbm2;
+  for (unsigned long r = 0; r < rounds; ++r) {
+    tchecker::clock_id_t const dim2 = 1 + rnd() % 20;
+    tchecker::clock_id_t const dim1 = 1 + rnd() % dim2;
+    if (!random_zone(dbm1, dim1) || !random_zone(dbm2, dim2))
+      continue;
+    std::vector<tchecker::clock_id_t> idx_clk(dim2);
+    std::iota(idx_clk.begin(), idx_clk.end(), 0);
+    std::shuffle(idx_clk.begin() + 1, idx_clk.end(), rnd);
+    idx_clk.resize(dim1);
+    std::vector<db_t> min1(dim1 * dim1), min2(dim1 * dim1);
+    tchecker_ext::dbm_ext::partial_min_scalar(min1.data(), dbm1.data(), dbm2.data(), dim1, dim2, idx_clk.data());
+    tchecker_ext::dbm_ext::partial_min(min2.data(), dbm1.data(), dbm2.data(), dim1, dim2, idx_clk.data());
+    // In place
+    std::vector<db_t> in_place = dbm1;
+    tchecker_ext::dbm_ext::partial_min(in_place.data(), in_place.data(), dbm2.data(), dim1, dim2, idx_clk.data());
+    if ((min1 != min2) || (min1 != in_place))
+      ++bad;
+  }
+  return bad;
+}
+
+
+int main(int argc, char * argv[])
+{
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [seed]" << std::endl;
+    return 1;
+  }
+  rnd.seed(argc == 2 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 5);
+
+  std::cout << "SIMD " << tchecker_ext::dbm_ext::simd_level_name(tchecker_ext::dbm_ext::simd_level()) << std::endl;
+  unsigned long const inclusion = check_alu_cases() + check_inclusion(200000) + check_db16(100000);
+  unsigned long const tighten = check_tighten(100000);
+  unsigned long const partial_min = check_partial_min(100000);
+  std::cout << "INCLUSION_MISMATCHES " << inclusion << std::endl;
+  std::cout << "TIGHTEN_MISMATCHES " << tighten << std::endl;
+  std::cout << "PARTIAL_MIN_MISMATCHES " << partial_min << std::endl;
+
+  return ((inclusion + tighten + partial_min == 0) ? 0 : 1);
+}
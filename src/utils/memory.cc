@@ -0,0 +1,164 @@
+/*
+ * This file is a part of the TChecker project.
+ *
+ * See files AUTHORS and LICENSE for copyright details.
+ *
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "tchecker_ext/utils/memory.hh"
+
+namespace tchecker_ext {
+
+  namespace memory {
+
+    tchecker_ext::memory::usage_t usage()
+    {
+      tchecker_ext::memory::usage_t u;
+#if defined(__linux__)
+      std::ifstream smaps("/proc/self/smaps_rollup");
+      std::string key;
+      std::size_t value;
+      std::string unit;
+      while (smaps >> key) {
+        if ((key == "Rss:") || (key == "AnonHugePages:")) {
+          smaps >> value >> unit;
+          (key == "Rss:" ? u.rss : u.huge_pages) = value * 1024;
+        }
+        smaps.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      }
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+      struct mallinfo2 mi = mallinfo2();
+      u.heap_reserved = mi.arena + mi.hblkhd;
+      u.heap_in_use = mi.uordblks + mi.hblkhd;
+#endif
+#endif
+      return u;
+    }
+
+
+    std::size_t resident()
+    {
+      std::size_t rss = 0;
+#if defined(__linux__)
+      std::ifstream statm("/proc/self/statm");
+      std::size_t size = 0;
+      if (statm >> size >> rss)
+        rss *= static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      else
+        rss = 0;
+#endif
+      return rss;
+    }
+
+
+    std::ostream & operator<< (std::ostream & os, tchecker_ext::memory::usage_t const & u)
+    {
+      os << "MEMORY_RSS " << u.rss << std::endl;
+      os << "MEMORY_HUGE_PAGES " << u.huge_pages << std::endl;
+      os << "MEMORY_HEAP_RESERVED " << u.heap_reserved << std::endl;
+      os << "MEMORY_HEAP_IN_USE " << u.heap_in_use << std::endl;
+      os << "MEMORY_HEAP_OCCUPANCY "
+         << (u.heap_reserved == 0 ? 0.0 : static_cast<double>(u.heap_in_use) / static_cast<double>(u.heap_reserved))
+         << std::endl;
+      return os;
+    }
+
+
+    block_allocator_t::block_allocator_t(bool huge_pages)
+    : _huge_pages(huge_pages),
+      _head(nullptr),
+      _end(nullptr),
+      _next_block_size(huge_page_size),
+      _reserved(0),
+      _used(0)
+    {}
+
+
+    block_allocator_t::~block_allocator_t()
+    {
+      release_all();
+    }
+
+
+    void * block_allocator_t::allocate(std::size_t bytes, std::size_t align)
+    {
+      assert((align != 0) && ((align & (align - 1)) == 0) && (align <= huge_page_size));
+      std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(_head) + align - 1) & ~(align - 1);
+      if ((_head == nullptr) || (p + bytes > reinterpret_cast<std::uintptr_t>(_end))) {
+        map_block(bytes);
+        p = reinterpret_cast<std::uintptr_t>(_head); // Blocks are huge page aligned
+      }
+      _used += p + bytes - reinterpret_cast<std::uintptr_t>(_head);
+      _head = reinterpret_cast<char *>(p + bytes);
+      return reinterpret_cast<void *>(p);
+    }
+
+
+    void block_allocator_t::release_all()
+    {
+      for (auto const & block : _blocks) {
+#if defined(__linux__)
+        munmap(block.first, block.second);
+#else
+        std::free(block.first);
+#endif
+      }
+      _blocks.clear();
+      _head = nullptr;
+      _end = nullptr;
+      _next_block_size = huge_page_size;
+      _reserved = 0;
+      _used = 0;
+    }
+
+
+    void block_allocator_t::map_block(std::size_t bytes)
+    {
+      std::size_t size = std::max(_next_block_size, (bytes + huge_page_size - 1) & ~(huge_page_size - 1));
+      char * block = nullptr;
+#if defined(__linux__)
+      // Map one more huge page, then unmap the unaligned head and tail
+      std::size_t const mapped = size + huge_page_size;
+      void * p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+        throw std::bad_alloc();
+      char * const raw = static_cast<char *>(p);
+      block = reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(raw) + huge_page_size - 1) & ~(huge_page_size - 1));
+      if (block > raw)
+        munmap(raw, block - raw);
+      if (raw + mapped > block + size)
+        munmap(block + size, raw + mapped - (block + size));
+#if defined(MADV_HUGEPAGE)
+      if (_huge_pages)
+        madvise(block, size, MADV_HUGEPAGE);
+#endif
+#else
+      block = static_cast<char *>(std::aligned_alloc(huge_page_size, size));
+      if (block == nullptr)
+        throw std::bad_alloc();
+#endif
+      _blocks.emplace_back(block, size);
+      _head = block;
+      _end = block + size;
+      _reserved += size;
+      _next_block_size = std::min(2 * size, max_block_size);
+    }
+
+  } // end of namespace memory
+
+} // end of namespace tchecker_ext